@@ -0,0 +1,656 @@
+/**
+ * @file graphBench.c
+ *
+ * Benchmark of the graph algorithms over synthetic graphs. The results are printed as CSV on the standard output:
+ *
+ * generator,directed,vertices,edges,algorithm,threads,reps,median_ms,p99_ms,edges_per_sec,peak_rss_kb
+ *
+ * Usage: graphBench [-m max log2 vertices] [-r repetitions] [-s seed] [-t threads]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "../include/graph.h"
+
+#define BENCH_MIN_SCALE 10
+#define BENCH_DEGREE 8
+#define BENCH_MAX_WEIGHT 100
+
+
+/* RANDOM GENERATOR - START */
+
+static unsigned long long rngState;
+
+static void rngSeed(unsigned long long seed) {
+  rngState = seed * 0x9E3779B97F4A7C15ull + 1;
+}
+
+/* xorshift64* */
+static unsigned long long rngNext() {
+  rngState ^= rngState >> 12;
+  rngState ^= rngState << 25;
+  rngState ^= rngState >> 27;
+  return rngState * 0x2545F4914F6CDD1Dull;
+}
+
+static int rngInt(int n) {
+  return (int) (rngNext() % (unsigned long long) n);
+}
+
+static double rngDouble() {
+  return (rngNext() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/* RANDOM GENERATOR - END */
+
+
+/* GRAPH GENERATORS - START */
+
+static void addMutation(edgeMutation *m, int source, int destination) {
+  m->type = INSERT_EDGE;
+  m->source = source;
+  m->destination = destination;
+  m->weight = 1 + rngInt(BENCH_MAX_WEIGHT);
+}
+
+static graph * buildGraph(int size, bool directed, edgeMutation *mutations, int nmutations) {
+  graph *g = initializeGraph(directed);
+
+  addVertex(g, size);
+  applyEdgeMutations(g, mutations, nmutations, false);
+  free(mutations);
+
+  return g;
+}
+
+/**
+ * R-MAT (Kronecker) graph: each edge recursively falls in one of the four quadrants of the adjacency matrix
+ * with probabilities 0.57, 0.19, 0.19, 0.05.
+ */
+static graph * generateRMAT(int scale, bool directed) {
+  int size = 1 << scale;
+  int nedges = size * BENCH_DEGREE;
+  edgeMutation *mutations = (edgeMutation *) malloc(sizeof(edgeMutation) * nedges);
+  int source;
+  int destination;
+  double p;
+
+  for(int i = 0; i < nedges; i++) {
+    source = 0;
+    destination = 0;
+    for(int bit = 0; bit < scale; bit++) {
+      p = rngDouble();
+      if(p >= 0.57 && p < 0.76) {
+        destination |= 1 << bit;
+      } else if(p >= 0.76 && p < 0.95) {
+        source |= 1 << bit;
+      } else if(p >= 0.95) {
+        source |= 1 << bit;
+        destination |= 1 << bit;
+      }
+    }
+    addMutation(&mutations[i], source, destination);
+  }
+
+  return buildGraph(size, directed, mutations, nedges);
+}
+
+/**
+ * Erdos-Renyi G(n, m) graph: the endpoints of each edge are chosen uniformly.
+ */
+static graph * generateErdosRenyi(int scale, bool directed) {
+  int size = 1 << scale;
+  int nedges = size * BENCH_DEGREE;
+  edgeMutation *mutations = (edgeMutation *) malloc(sizeof(edgeMutation) * nedges);
+
+  for(int i = 0; i < nedges; i++) {
+    addMutation(&mutations[i], rngInt(size), rngInt(size));
+  }
+
+  return buildGraph(size, directed, mutations, nedges);
+}
+
+/**
+ * 2D grid graph (road-like): each vertex is linked to its right and lower neighbours, in both directions if directed.
+ */
+static graph * generateGrid(int scale, bool directed) {
+  int side = 1 << (scale / 2);
+  int size = side * (1 << (scale - scale / 2));
+  int nedges = 0;
+  edgeMutation *mutations = (edgeMutation *) malloc(sizeof(edgeMutation) * size * 4);
+
+  for(int v = 0; v < size; v++) {
+    if(v % side != side - 1) {
+      addMutation(&mutations[nedges++], v, v + 1);
+      if(directed) {
+        addMutation(&mutations[nedges++], v + 1, v);
+      }
+    }
+    if(v + side < size) {
+      addMutation(&mutations[nedges++], v, v + side);
+      if(directed) {
+        addMutation(&mutations[nedges++], v + side, v);
+      }
+    }
+  }
+
+  return buildGraph(size, directed, mutations, nedges);
+}
+
+/**
+ * Power-law (Chung-Lu) graph: the endpoints are chosen with probability proportional to (i+1)^(-1/(gamma-1)), gamma = 2.5.
+ * The vertices are then shuffled, so the hubs are not the first vertices.
+ */
+static graph * generatePowerLaw(int scale, bool directed) {
+  int size = 1 << scale;
+  int nedges = size * BENCH_DEGREE;
+  edgeMutation *mutations = (edgeMutation *) malloc(sizeof(edgeMutation) * nedges);
+  double *cumulative = (double *) malloc(sizeof(double) * size);
+  int *permutation = (int *) malloc(sizeof(int) * size);
+  double total = 0;
+  int endpoint[2];
+  int j;
+
+  for(int v = 0; v < size; v++) {
+    total += 1.0 / pow(v + 1, 2.0 / 3.0);
+    cumulative[v] = total;
+    permutation[v] = v;
+  }
+  for(int v = size - 1; v > 0; v--) {
+    j = rngInt(v + 1);
+    endpoint[0] = permutation[v];
+    permutation[v] = permutation[j];
+    permutation[j] = endpoint[0];
+  }
+
+  for(int i = 0; i < nedges; i++) {
+    for(int e = 0; e < 2; e++) {
+      double x = rngDouble() * total;
+      int low = 0;
+      int high = size - 1;
+      while(low < high) {
+        int middle = (low + high) / 2;
+        if(cumulative[middle] < x) {
+          low = middle + 1;
+        } else {
+          high = middle;
+        }
+      }
+      endpoint[e] = permutation[low];
+    }
+    addMutation(&mutations[i], endpoint[0], endpoint[1]);
+  }
+
+  free(cumulative);
+  free(permutation);
+  return buildGraph(size, directed, mutations, nedges);
+}
+
+/* GRAPH GENERATORS - END */
+
+
+/* ALGORITHMS - START */
+
+typedef struct benchAlgorithm benchAlgorithm;
+
+/**
+ * An algorithm to time: run is called on the graph and must free its own result.
+ * The algorithm is skipped on graphs with more than maxVertices vertices (the quadratic and cubic ones).
+ */
+struct benchAlgorithm {
+  const char *name;
+  bool directed;
+  int maxVertices;
+  void (*run)(graph *g);
+};
+
+static void runBFS(graph *g) {
+  destroyVisit(getBFS(g, 0));
+}
+
+static void runDFS(graph *g) {
+  destroyVisit(getDFS(g, 0));
+}
+
+static void runDFSTOTForest(graph *g) {
+  destroyVisit(getDFSTOTForest(g, 0));
+}
+
+static void runIsCyclic(graph *g) {
+  isCyclic(g);
+}
+
+static void runIsConnected(graph *g) {
+  isConnected(g);
+}
+
+static void runIsStronglyConnected(graph *g) {
+  isStronglyConnected(g);
+}
+
+static void runConnectedComponents(graph *g) {
+  destroyLists(getConnectedComponents(g));
+}
+
+static void runParallelConnectedComponents(graph *g) {
+  destroyLists(getParallelConnectedComponents(g));
+}
+
+static void runStronglyConnectedComponents(graph *g) {
+  destroyLists(getStronglyConnectedComponents(g));
+}
+
+static void runTransposedGraph(graph *g) {
+  destroyGraph(getTransposedGraph(g));
+}
+
+/**
+ * The index is built once, then the transposed graph is only a view.
+ */
+static void runTransposedView(graph *g) {
+  enableReverseIndex(g);
+  destroyGraph(getTransposedGraph(g));
+  destroyLists(getStronglyConnectedComponents(g));
+  disableReverseIndex(g);
+}
+
+static void runTopologicalSort(graph *g) {
+  free(getTopologicalSort(g));
+}
+
+static void runKahnTopologicalSort(graph *g) {
+  lists *levels = NULL;
+
+  free(getKahnTopologicalSort(g, &levels));
+  if(levels != NULL) {
+    destroyLists(levels);
+  }
+}
+
+static void runDijkstra(graph *g) {
+  destroyVisit(getDijkstraShortestPaths(g, 0));
+}
+
+static void runBellmanFord(graph *g) {
+  visitInfo *visit = getBellmanFordShortestPaths(g, 0);
+
+  if(visit != NULL) {
+    destroyVisit(visit);
+  }
+}
+
+static void runFloydWarshall(graph *g) {
+  int **distance = getFloydWarshallShortestsPaths(g);
+
+  for(int i = 0; distance != NULL && i < g->size; i++) {
+    free(distance[i]);
+  }
+  free(distance);
+}
+
+static void runDynamicSSSP(graph *g) {
+  destroyDynamicSSSP(initializeDynamicSSSP(g, 0));
+}
+
+static void destroyForest(graph *forest) {
+  if(forest != NULL) {
+    destroyGraph(forest);
+  }
+}
+
+/**
+ * 256 point-to-point queries, half BFS and half Dijkstra, between spread vertices.
+ */
+static void runQueries(graph *g) {
+  graphQuery queries[256];
+
+  for(int i = 0; i < 256; i++) {
+    queries[i].type = i % 2 == 0 ? BFS_QUERY : DIJKSTRA_QUERY;
+    queries[i].source = (int) ((long) i * 7919 % g->size);
+    queries[i].target = (int) ((long) i * 104729 % g->size);
+  }
+  runQueryBatch(g, queries, 256);
+}
+
+/**
+ * 256 breadth-first-searches from spread sources, one at a time and as a single multi-source visit.
+ */
+static void runRepeatedBFS(graph *g) {
+  for(int i = 0; i < 256; i++) {
+    destroyVisit(getBFS(g, (int) ((long) i * 7919 % g->size)));
+  }
+}
+
+static void runMultiSourceBFS(graph *g) {
+  int sources[256];
+
+  for(int i = 0; i < 256; i++) {
+    sources[i] = (int) ((long) i * 7919 % g->size);
+  }
+  free(getMultiSourceBFSSummary(g, sources, 256));
+}
+
+static void runBetweenness(graph *g) {
+  free(getBetweennessCentrality(g, false, 0, 0));
+}
+
+static void runSampledBetweenness(graph *g) {
+  free(getBetweennessCentrality(g, true, 64, 1));
+}
+
+static void runCloseness(graph *g) {
+  free(getClosenessCentrality(g, false, 0, 0));
+}
+
+static void runPageRank(graph *g) {
+  free(getPageRank(g, 0.85, 1e-9, 100, NULL));
+}
+
+static void runPushPageRank(graph *g) {
+  free(getPushPersonalizedPageRank(g, 0, 0.85, 1e-4, NULL));
+}
+
+static void runTriangleCount(graph *g) {
+  getTriangleCount(g, NULL);
+}
+
+static void runClusteringCoefficients(graph *g) {
+  free(getClusteringCoefficients(g));
+}
+
+static void runCoreNumbers(graph *g) {
+  free(getCoreNumbers(g, NULL));
+}
+
+static void runKCore(graph *g) {
+  destroyGraph(getKCore(g, 3, NULL));
+}
+
+static void runBiconnectedComponents(graph *g) {
+  destroyBiconnectedComponents(getBiconnectedComponents(g));
+}
+
+static void runMaxFlow(graph *g) {
+  flowNetwork *f = initializeFlowNetwork(g);
+
+  getMaxFlow(f, 0, g->size - 1);
+  destroyFlowNetwork(f);
+}
+
+/**
+ * 16 rounds of halving the capacity of a spread edge and solving again from the previous flow.
+ */
+static void runWarmMaxFlow(graph *g) {
+  flowNetwork *f = initializeFlowNetwork(g);
+  weightedEdge e;
+
+  getMaxFlow(f, 0, g->size - 1);
+  for(int i = 0; i < 16; i++) {
+    e = f->edges[(int) ((long) i * 7919 % f->nedges)];
+    setFlowCapacity(f, e.source, e.destination, e.weight / 2);
+    getMaxFlow(f, 0, g->size - 1);
+  }
+  destroyFlowNetwork(f);
+}
+
+static void runPrimMST(graph *g) {
+  destroyForest(getPrimMST(g));
+}
+
+static void runKruskalMST(graph *g) {
+  destroyForest(getKruskalMST(g));
+}
+
+static void runFilterKruskalMST(graph *g) {
+  destroyForest(getFilterKruskalMST(g));
+}
+
+static void runBoruvkaMST(graph *g) {
+  destroyForest(getBoruvkaMST(g));
+}
+
+static void runPrimMSF(graph *g) {
+  destroyForest(getPrimMSF(g, NULL));
+}
+
+static void runKruskalMSF(graph *g) {
+  destroyForest(getKruskalMSF(g, NULL));
+}
+
+static void runSortEdgesByWeight(graph *g) {
+  int nedges;
+  weightedEdge *edges = getEdges(g, &nedges);
+
+  sortEdgesByWeight(edges, nedges);
+  free(edges);
+}
+
+static void runDynamicConnectivity(graph *g) {
+  enableDynamicConnectivity(g);
+  getNumberOfComponents(g);
+  disableDynamicConnectivity(g);
+}
+
+/**
+ * Inserts g->size random edges in a batch, then removes the inserted ones in a second batch (the graph is left unchanged).
+ */
+static void runEdgeMutations(graph *g) {
+  edgeMutation *inserts = (edgeMutation *) malloc(sizeof(edgeMutation) * g->size);
+  edgeMutation *deletes = (edgeMutation *) malloc(sizeof(edgeMutation) * g->size);
+  int ndeletes = 0;
+
+  for(int i = 0; i < g->size; i++) {
+    addMutation(&inserts[i], rngInt(g->size), rngInt(g->size));
+  }
+  applyEdgeMutations(g, inserts, g->size, true);
+
+  for(int i = 0; i < g->size; i++) {
+    if(inserts[i].applied) {
+      deletes[ndeletes] = inserts[i];
+      deletes[ndeletes++].type = DELETE_EDGE;
+    }
+  }
+  applyEdgeMutations(g, deletes, ndeletes, true);
+
+  free(inserts);
+  free(deletes);
+}
+
+static void runCSRBFS(graph *g) {
+  csrGraph *c = getCSRGraph(g);
+
+  destroyVisit(getCSRBFS(c, 0));
+  destroyCSRGraph(c);
+}
+
+static void runCSRDijkstra(graph *g) {
+  csrGraph *c = getCSRGraph(g);
+
+  destroyVisit(getCSRDijkstraShortestPaths(c, 0));
+  destroyCSRGraph(c);
+}
+
+static void runCompressGraph(graph *g) {
+  destroyCompressedGraph(compressGraph(g));
+}
+
+/**
+ * The compression is timed too: subtract the compressGraph row to get the visit alone.
+ */
+static void runCompressedBFS(graph *g) {
+  compressedGraph *c = compressGraph(g);
+
+  destroyVisit(getCompressedBFS(c, 0));
+  destroyCompressedGraph(c);
+}
+
+static void runCompressedConnectedComponents(graph *g) {
+  compressedGraph *c = compressGraph(g);
+
+  destroyLists(getCompressedConnectedComponents(c));
+  destroyCompressedGraph(c);
+}
+
+/**
+ * The graph is renumbered in place, so it runs after the other algorithms.
+ */
+static void runReorderGraph(graph *g) {
+  destroyVertexMap(reorderGraph(g, RCM_ORDER));
+}
+
+static benchAlgorithm algorithms[] = {
+  {"getBFS", false, INT_MAX, runBFS},
+  {"getDFS", false, 1 << 16, runDFS},
+  {"getDFSTOTForest", true, 1 << 16, runDFSTOTForest},
+  {"isCyclic", true, 1 << 16, runIsCyclic},
+  {"isConnected", false, INT_MAX, runIsConnected},
+  {"getConnectedComponents", false, 1 << 14, runConnectedComponents},
+  {"getParallelConnectedComponents", false, INT_MAX, runParallelConnectedComponents},
+  {"getNumberOfComponents (dynamic)", false, INT_MAX, runDynamicConnectivity},
+  {"isStronglyConnected", true, 1 << 14, runIsStronglyConnected},
+  {"getStronglyConnectedComponents", true, 1 << 14, runStronglyConnectedComponents},
+  {"getTransposedGraph", true, INT_MAX, runTransposedGraph},
+  {"enableReverseIndex + getStronglyConnectedComponents", true, 1 << 14, runTransposedView},
+  {"getTopologicalSort", true, 1 << 16, runTopologicalSort},
+  {"getKahnTopologicalSort", true, INT_MAX, runKahnTopologicalSort},
+  {"getDijkstraShortestPaths", true, 1 << 12, runDijkstra},
+  {"getBellmanFordShortestPaths", true, 1 << 12, runBellmanFord},
+  {"getFloydWarshallShortestsPaths", true, 1 << 10, runFloydWarshall},
+  {"initializeDynamicSSSP", true, INT_MAX, runDynamicSSSP},
+  {"runQueryBatch (256 point-to-point)", true, INT_MAX, runQueries},
+  {"getBFS (256 sources)", false, 1 << 16, runRepeatedBFS},
+  {"getMultiSourceBFSSummary (256 sources)", false, 1 << 16, runMultiSourceBFS},
+  {"getBetweennessCentrality", false, 1 << 12, runBetweenness},
+  {"getBetweennessCentrality (weighted, 64 samples)", true, INT_MAX, runSampledBetweenness},
+  {"getClosenessCentrality", false, 1 << 12, runCloseness},
+  {"getPageRank", true, INT_MAX, runPageRank},
+  {"getPushPersonalizedPageRank", true, INT_MAX, runPushPageRank},
+  {"getTriangleCount", false, INT_MAX, runTriangleCount},
+  {"getClusteringCoefficients", false, INT_MAX, runClusteringCoefficients},
+  {"getCoreNumbers", false, INT_MAX, runCoreNumbers},
+  {"getKCore (k = 3)", false, INT_MAX, runKCore},
+  {"getBiconnectedComponents", false, INT_MAX, runBiconnectedComponents},
+  {"getMaxFlow", true, INT_MAX, runMaxFlow},
+  {"getMaxFlow + 16 x setFlowCapacity (warm start)", true, INT_MAX, runWarmMaxFlow},
+  {"getPrimMST", false, INT_MAX, runPrimMST},
+  {"getKruskalMST", false, INT_MAX, runKruskalMST},
+  {"getFilterKruskalMST", false, INT_MAX, runFilterKruskalMST},
+  {"getBoruvkaMST", false, INT_MAX, runBoruvkaMST},
+  {"getPrimMSF", false, INT_MAX, runPrimMSF},
+  {"getKruskalMSF", false, INT_MAX, runKruskalMSF},
+  {"sortEdgesByWeight", false, INT_MAX, runSortEdgesByWeight},
+  {"applyEdgeMutations", false, INT_MAX, runEdgeMutations},
+  {"getCSRGraph + getCSRBFS", false, INT_MAX, runCSRBFS},
+  {"getCSRGraph + getCSRDijkstraShortestPaths", true, INT_MAX, runCSRDijkstra},
+  {"compressGraph", false, INT_MAX, runCompressGraph},
+  {"compressGraph + getCompressedBFS", false, INT_MAX, runCompressedBFS},
+  {"compressGraph + getCompressedConnectedComponents", false, INT_MAX, runCompressedConnectedComponents},
+  {"reorderGraph (RCM)", false, INT_MAX, runReorderGraph}
+};
+
+/* ALGORITHMS - END */
+
+
+/* TIMING - START */
+
+static double now() {
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1000.0 + t.tv_nsec / 1000000.0;
+}
+
+static long peakRSS() {
+  struct rusage usage;
+
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+static int compareTimes(const void *a, const void *b) {
+  double x = *(const double *) a;
+  double y = *(const double *) b;
+
+  return (x > y) - (x < y);
+}
+
+/**
+ * Runs the algorithm reps times and prints a CSV row. The percentiles use the nearest rank,
+ * the peak RSS is the one of the whole process so far.
+ */
+static void benchmark(const char *generator, graph *g, benchAlgorithm *algorithm, int reps) {
+  double *times = (double *) malloc(sizeof(double) * reps);
+  double start;
+  double median;
+  double p99;
+  int nedges = getNumberOfEdges(g);
+
+  for(int r = 0; r < reps; r++) {
+    start = now();
+    algorithm->run(g);
+    times[r] = now() - start;
+  }
+  qsort(times, reps, sizeof(double), compareTimes);
+  median = times[(reps - 1) / 2];
+  p99 = times[(int) ceil(0.99 * reps) - 1];
+
+  printf("%s,%s,%d,%d,%s,%d,%d,%.3f,%.3f,%.0f,%ld\n", generator, g->directed ? "true" : "false", g->size, nedges,
+         algorithm->name, getNumberOfThreads(), reps, median, p99, median > 0 ? nedges / (median / 1000.0) : 0, peakRSS());
+  fflush(stdout);
+  free(times);
+}
+
+/* TIMING - END */
+
+
+int main(int argc, char **argv) {
+  const char *generatorNames[] = {"rmat", "erdos-renyi", "grid", "power-law"};
+  graph *(*generators[])(int, bool) = {generateRMAT, generateErdosRenyi, generateGrid, generatePowerLaw};
+  int nalgorithms = sizeof(algorithms) / sizeof(algorithms[0]);
+  int maxScale = 14;
+  int reps = 5;
+  unsigned long long seed = 1;
+  graph *g[2];
+  int option;
+
+  while((option = getopt(argc, argv, "m:r:s:t:")) != -1) {
+    if(option == 'm') {
+      maxScale = atoi(optarg);
+    } else if(option == 'r') {
+      reps = atoi(optarg) > 0 ? atoi(optarg) : 1;
+    } else if(option == 's') {
+      seed = strtoull(optarg, NULL, 10);
+    } else if(option == 't') {
+      setNumberOfThreads(atoi(optarg));
+    } else {
+      fprintf(stderr, "Usage: %s [-m max log2 vertices] [-r repetitions] [-s seed] [-t threads]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  printf("generator,directed,vertices,edges,algorithm,threads,reps,median_ms,p99_ms,edges_per_sec,peak_rss_kb\n");
+  for(int scale = BENCH_MIN_SCALE; scale <= maxScale; scale += 2) {
+    for(int i = 0; i < 4; i++) {
+      for(int directed = 0; directed < 2; directed++) {
+        rngSeed(seed + scale * 8 + i * 2 + directed);
+        g[directed] = generators[i](scale, directed);
+      }
+
+      for(int a = 0; a < nalgorithms; a++) {
+        if(g[algorithms[a].directed]->size <= algorithms[a].maxVertices) {
+          benchmark(generatorNames[i], g[algorithms[a].directed], &algorithms[a], reps);
+        }
+      }
+
+      destroyGraph(g[0]);
+      destroyGraph(g[1]);
+    }
+  }
+
+  return 0;
+}
@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <pthread.h>
 #include "../include/utility.h"
 
 #define MAX_DISTANCE 99999
@@ -32,6 +33,38 @@ struct edgenode {
   struct edgenode *next;
 };
 
+typedef struct connectivity connectivity;
+
+/**
+ * @struct connectivity
+ * @brief This structure represents the connected components of an undirected graph, kept up to date while the graph changes.
+ *
+ * Each vertex has a component id and the ids are merged with a union find when an edge joins two components.
+ * When an edge is removed, two searches start from its endpoints and advance one vertex each in turn: if they meet
+ * nothing changes, otherwise the search that ends first has visited the smaller side, which takes a new id.
+ * @see enableDynamicConnectivity
+ * @var connectivity::component
+ * The component id of each vertex.
+ * @var connectivity::ids
+ * The union find of the component ids.
+ * @var connectivity::nids
+ * The number of ids used (when all the ids of the union find are used the components are computed again).
+ * @var connectivity::count
+ * The number of connected components.
+ * @var connectivity::mark
+ * Work array of the searches (the side that reached each vertex, 0 if none).
+ * @var connectivity::queue
+ * Work array of the searches (the queues of the two sides).
+ */
+struct connectivity {
+  int *component;
+  k_union_find *ids;
+  int nids;
+  int count;
+  int *mark;
+  int *queue;
+};
+
 typedef struct graph graph;
 
 /**
@@ -43,11 +76,85 @@ typedef struct graph graph;
  * The number of vertices in the graph.
  * @var graph::directed
  * Indicates if the graph is directed or not.
+ * @var graph::lazyRemoval
+ * Indicates if removeVertex leaves a tombstone instead of renumbering the vertices.
+ * @var graph::removed
+ * Indicates for each vertex if it is a tombstone (NULL if there are no tombstones).
+ * @var graph::removedCount
+ * The number of tombstones in the graph.
+ * @var graph::connectivity
+ * The connected components kept up to date by the graph operations (NULL if they are not maintained).
+ * @var graph::inAdjList
+ * The incoming edges of each vertex of a directed graph, kept up to date by the graph operations (NULL if they are
+ * not maintained). The edge field of a node is the source of the edge.
+ * @var graph::view
+ * Indicates if the graph shares the adjacency lists of another graph (see getTransposedGraph).
  */
 struct graph {
   edgenode **adjList;
   int size;
   bool directed;
+  bool lazyRemoval;
+  bool *removed;
+  int removedCount;
+  connectivity *connectivity;
+  edgenode **inAdjList;
+  bool view;
+};
+
+typedef struct weightedEdge weightedEdge;
+
+/**
+ * @struct weightedEdge
+ * @brief This structure represents an edge stored outside of the adjacency lists.
+ * @var weightedEdge::source
+ * The source vertex of the edge.
+ * @var weightedEdge::destination
+ * The destination vertex of the edge.
+ * @var weightedEdge::weight
+ * The weight of the edge.
+ */
+struct weightedEdge {
+  int source;
+  int destination;
+  int weight;
+};
+
+/**
+ * @enum mutationType
+ * @brief The kind of change applied by an edge mutation.
+ * @var mutationType::INSERT_EDGE
+ * Adds the edge with the given weight (it fails if the edge already exists).
+ * @var mutationType::DELETE_EDGE
+ * Removes the edge (it fails if the edge doesn't exist).
+ * @var mutationType::SET_EDGE_WEIGHT
+ * Sets the weight of the edge (it fails if the edge doesn't exist).
+ */
+enum mutationType {INSERT_EDGE, DELETE_EDGE, SET_EDGE_WEIGHT};
+
+typedef struct edgeMutation edgeMutation;
+
+/**
+ * @struct edgeMutation
+ * @brief This structure represents a change of an edge in a batch of mutations.
+ * @see applyEdgeMutations
+ * @var edgeMutation::type
+ * The kind of change.
+ * @var edgeMutation::source
+ * The source vertex of the edge.
+ * @var edgeMutation::destination
+ * The destination vertex of the edge.
+ * @var edgeMutation::weight
+ * The weight of the edge (ignored by DELETE_EDGE).
+ * @var edgeMutation::applied
+ * It is set by applyEdgeMutations: true if the mutation has been applied, false otherwise.
+ */
+struct edgeMutation {
+  enum mutationType type;
+  int source;
+  int destination;
+  int weight;
+  bool applied;
 };
 
 /**
@@ -112,6 +219,14 @@ void printGraph(graph *g);
  */
 visitInfo * initializeVisit(graph *g);
 
+/**
+ * @brief Initializes the visit information for a traversal of size vertices.
+ *
+ * @param size the number of vertices.
+ * @return the visit information initialized.
+ */
+visitInfo * initializeVisitSize(int size);
+
 /* INITIALIZATION - END */
 
 
@@ -144,6 +259,26 @@ bool containsVertex(graph *g, int vertex);
  */
 bool removeVertex(graph *g, int vertex);
 
+/**
+ * @brief Enables or disables the lazy removal of the vertices.
+ *
+ * With lazy removal, removeVertex only deletes the edges incident to the vertex and marks it as a tombstone:
+ * the other vertices keep their numbers until compactGraph is called. A tombstone is not contained in the graph
+ * and it is seen by the algorithms as an isolated vertex.
+ *
+ * @param g the graph.
+ * @param lazy true to leave tombstones, false to renumber the vertices on each removal.
+ */
+void setLazyVertexRemoval(graph *g, bool lazy);
+
+/**
+ * @brief Removes the tombstones from the graph, renumbering the remaining vertices in a single pass.
+ *
+ * @param g the graph.
+ * @return for each old vertex number, the new number of the vertex (-1 for the tombstones). It must be freed by the caller.
+ */
+int * compactGraph(graph *g);
+
 /**
  * @brief Adds an edge to the graph.
  *
@@ -172,7 +307,7 @@ bool addEdgeWeight(graph *g, int source, int destination, int weight);
  * @param source the source vertex of the edge.
  * @param destination the destination vertex of the edge.
  * @param weight the weight of the edge.
- * @return true if the edge has been added, false otherwise.
+ * @return true if the weight has been set, false otherwise (the edge does not exists).
  */
 bool setEdgeWeight(graph *g, int source, int destination, int weight);
 
@@ -223,6 +358,24 @@ int getNumberOfEdges(graph *g);
  */
 edgenode * getAdjacent(graph *g, int vertex);
 
+/**
+ * @brief Gets the edges of the graph in a contiguous array (each edge of an undirected graph is listed once, with source < destination).
+ *
+ * @param g the graph.
+ * @param nedges it will contain the number of edges in the array.
+ * @return the edges (it must be freed by the caller).
+ */
+weightedEdge * getEdges(graph *g, int *nedges);
+
+/**
+ * @brief Sorts an array of edges by ascending weight. It is used a stable parallel radix sort.
+ *
+ * @param edges the edges.
+ * @param nedges the number of edges.
+ * @see setNumberOfThreads
+ */
+void sortEdgesByWeight(weightedEdge *edges, int nedges);
+
 /** 
  * @brief Checks if the graph is cyclic.
  *
@@ -265,6 +418,18 @@ bool isStronglyConnected(graph *g);
  */
 lists * getConnectedComponents(graph *g);
 
+/**
+ * @brief Gets the connected components of an undirected graph using many threads.
+ *
+ * It is used the Afforest algorithm over a lock-free union find, without any recursion.
+ * The components are listed in the same order of getConnectedComponents.
+ *
+ * @param g the graph.
+ * @return the connected components.
+ * @see setNumberOfThreads
+ */
+lists * getParallelConnectedComponents(graph *g);
+
 /**
  * @brief Gets the strongly connected components of a directed graph.
  *
@@ -276,6 +441,11 @@ lists * getStronglyConnectedComponents(graph *g);
 /**
  * @brief Gets the transposed graph of the input graph.
  *
+ * If the reverse index of a directed graph is enabled, no edge is copied: the transposed graph is a read-only view
+ * that swaps the adjacency lists with the incoming edges, and it is valid until the input graph is changed.
+ * Otherwise the transposed graph is a new graph with the same weights.
+ * In both cases it is destroyed with destroyGraph.
+ *
  * @param g the graph.
  * @return the transposed graph.
  */
@@ -298,9 +468,159 @@ lists * computeComponents(graph *g, int *order);
  */
 int * getTopologicalSort(graph *g);
 
+/**
+ * @brief Gets the topological sort of the graph using the Kahn algorithm.
+ *
+ * The cycle detection is performed in the same pass: if some vertex is never freed of its incoming edges the graph is cyclic.
+ *
+ * @param g the graph.
+ * @param levels if not NULL, it will contain the levels of the sort (each level is a set of vertices that doesn't depend on each other).
+ * @return the topological sort (returns NULL if the graph is undirected or cyclic).
+ */
+int * getKahnTopologicalSort(graph *g, lists **levels);
+
 /* BASIC GRAPH OPERATIONS - END */
 
 
+/* REVERSE INDEX - START */
+
+/**
+ * @brief Starts to keep the incoming edges of each vertex of a directed graph, so the predecessors of a vertex are
+ * found in time proportional to its in-degree. The index is updated by all the graph operations.
+ *
+ * @param g the graph.
+ * @return true if the index is enabled, false if the graph is undirected (its incoming edges are the adjacency lists).
+ */
+bool enableReverseIndex(graph *g);
+
+/**
+ * @brief Stops to keep the incoming edges of the vertices and frees them.
+ *
+ * @param g the graph.
+ */
+void disableReverseIndex(graph *g);
+
+/**
+ * @brief Gets the incoming edges of a vertex: the edge field of each node is the source of the edge.
+ *
+ * @param g the graph.
+ * @param vertex the vertex.
+ * @return the incoming edges (the adjacency list for an undirected graph, NULL if the vertex doesn't exist or the
+ * reverse index of a directed graph is not enabled).
+ */
+edgenode * getIncomingEdges(graph *g, int vertex);
+
+/* REVERSE INDEX - END */
+
+
+/* DYNAMIC CONNECTIVITY - START */
+
+/**
+ * @brief Starts to maintain the connected components of an undirected graph.
+ *
+ * From now on addVertex, addEdge, removeEdge and removeVertex keep the components up to date, while
+ * isConnected, getConnectedComponents, getNumberOfComponents and sameComponent don't need to visit the graph.
+ *
+ * @param g the graph.
+ * @return true if the components are maintained, false otherwise (the graph is directed).
+ */
+bool enableDynamicConnectivity(graph *g);
+
+/**
+ * @brief Stops to maintain the connected components of the graph.
+ *
+ * @param g the graph.
+ */
+void disableDynamicConnectivity(graph *g);
+
+/**
+ * @brief Gets the number of connected components of an undirected graph (the tombstones are not counted).
+ *
+ * @param g the graph.
+ * @return the number of connected components (returns -1 if the graph is directed).
+ */
+int getNumberOfComponents(graph *g);
+
+/**
+ * @brief Checks if two vertices are in the same connected component of an undirected graph.
+ *
+ * @param g the graph.
+ * @param a the first vertex.
+ * @param b the second vertex.
+ * @return true if the vertices are in the same component, false otherwise.
+ */
+bool sameComponent(graph *g, int a, int b);
+
+/**
+ * @brief Utility function for enableDynamicConnectivity and the batch operations. Computes again all the components.
+ *
+ * @param g the graph.
+ */
+void connectivityRebuild(graph *g);
+
+/**
+ * @brief Utility function for addVertex. Gives a new component to each new vertex.
+ *
+ * @param g the graph (with the new vertices already added).
+ * @param n the number of new vertices.
+ */
+void connectivityAddVertices(graph *g, int n);
+
+/**
+ * @brief Utility function for addEdge. Merges the components of the endpoints.
+ *
+ * @param g the graph.
+ * @param a the first endpoint.
+ * @param b the second endpoint.
+ */
+void connectivityAddEdge(graph *g, int a, int b);
+
+/**
+ * @brief Utility function for removeEdge. Splits the component of the endpoints if the edge was a bridge.
+ *
+ * @param g the graph (with the edge already removed).
+ * @param a the first endpoint.
+ * @param b the second endpoint.
+ */
+void connectivityRemoveEdge(graph *g, int a, int b);
+
+/* DYNAMIC CONNECTIVITY - END */
+
+
+/* BATCH OPERATIONS - START */
+
+/**
+ * @brief Applies a batch of edge mutations to the graph.
+ *
+ * The mutations are grouped by source vertex and each adjacency list is walked twice, whatever the number
+ * of mutations on it. The mutations of the same edge are applied in the order of the array.
+ * In an undirected graph the mutations of a self-loop are not applied.
+ *
+ * @param g the graph.
+ * @param mutations the mutations (the applied field of each mutation is set).
+ * @param nmutations the number of mutations.
+ * @param parallel if true, disjoint ranges of source vertices are updated by different threads.
+ * @return the number of mutations applied.
+ * @see setNumberOfThreads
+ */
+int applyEdgeMutations(graph *g, edgeMutation *mutations, int nmutations, bool parallel);
+
+/**
+ * @brief Removes a batch of vertices from the graph in a single pass over the adjacency lists.
+ *
+ * With lazy removal the vertices are left as tombstones, otherwise the graph is compacted once at the end.
+ *
+ * @param g the graph.
+ * @param vertices the vertices to remove.
+ * @param n the number of vertices.
+ * @return the number of vertices removed.
+ * @see setLazyVertexRemoval
+ */
+int removeVertices(graph *g, int *vertices, int n);
+
+/* BATCH OPERATIONS - END */
+
+
 /* GRAPH TRAVERSAL - START */
 
 /**
@@ -385,6 +705,15 @@ int ** getFloydWarshallShortestsPaths(graph *g);
  */
 graph * getPrimMST(graph *g);
 
+/**
+ * @brief Performs the Prim algorithm to get the minimum spanning forest of the graph in a single pass (no connectivity check is needed).
+ *
+ * @param g the graph.
+ * @param ntrees if not NULL, it will contain the number of trees in the forest.
+ * @return the minimum spanning forest (returns NULL if the graph is directed).
+ */
+graph * getPrimMSF(graph *g, int *ntrees);
+
 /**
  * @brief Performs the Kruskal algorithm to get the minumum spanning tree of the graph.
  *
@@ -393,9 +722,1115 @@ graph * getPrimMST(graph *g);
  */
 graph * getKruskalMST(graph *g);
 
+/**
+ * @brief Performs the Kruskal algorithm to get the minimum spanning forest of the graph in a single pass (no connectivity check is needed).
+ *
+ * @param g the graph.
+ * @param ntrees if not NULL, it will contain the number of trees in the forest.
+ * @return the minimum spanning forest (returns NULL if the graph is directed).
+ */
+graph * getKruskalMSF(graph *g, int *ntrees);
+
+/**
+ * @brief Performs the Filter-Kruskal algorithm to get the minimum spanning tree of the graph.
+ *
+ * The edges are partitioned around a pivot weight: the light part is solved first, then the heavy edges
+ * whose endpoints are already in the same tree are filtered out before being sorted.
+ *
+ * @param g the graph.
+ * @return the minimum spanning tree.
+ */
+graph * getFilterKruskalMST(graph *g);
+
+/**
+ * @brief Performs the Boruvka algorithm to get the minimum spanning forest of the graph using many threads.
+ *
+ * In each round every tree selects its lightest outgoing edge in parallel (with an atomic minimum),
+ * then the trees are merged with a lock-free union find. A disconnected graph gives a minimum spanning forest.
+ *
+ * @param g the graph.
+ * @return the minimum spanning forest (returns NULL if the graph is directed).
+ * @see setNumberOfThreads
+ */
+graph * getBoruvkaMST(graph *g);
+
 /* MINUMUM SPANNING TREE - END */
 
 
+/* DYNAMIC SHORTEST PATH - START */
+
+typedef struct dynamicSSSP dynamicSSSP;
+
+/**
+ * @struct dynamicSSSP
+ * @brief This structure represents the shortest paths from a source that are kept up to date while the graph changes.
+ *
+ * The edges must be changed through the dynamicSSSP functions: the cost of an update is proportional to the
+ * number of vertices whose distance changes (and to their degree), not to the size of the graph. The vertices
+ * can be added with addVertex at any time: they are unreachable until an edge reaches them.
+ * @var dynamicSSSP::g
+ * The graph (the weights must not be negative).
+ * @var dynamicSSSP::source
+ * The source of the shortest paths.
+ * @var dynamicSSSP::visit
+ * The visit information: the distance and the parent of each vertex in the shortest paths tree.
+ * @var dynamicSSSP::size
+ * The number of vertices covered by the visit information (it grows with the graph).
+ * @var dynamicSSSP::ownsReverseIndex
+ * Indicates if the reverse index of the graph has been enabled by the dynamic shortest paths (it is disabled again
+ * when they are destroyed).
+ */
+struct dynamicSSSP {
+  graph *g;
+  int source;
+  visitInfo *visit;
+  int size;
+  bool ownsReverseIndex;
+};
+
+/**
+ * @brief Initializes the dynamic shortest paths computing them with the Dijkstra algorithm.
+ * The reverse index of a directed graph is enabled, if it is not already, to find the incoming edges.
+ *
+ * @param g the graph.
+ * @param source the source of the shortest paths.
+ * @return the dynamic shortest paths (returns NULL if the source doesn't exist or some weight is negative).
+ */
+dynamicSSSP * initializeDynamicSSSP(graph *g, int source);
+
+/**
+ * @brief Adds an edge to the graph and updates the shortest paths.
+ *
+ * @param d the dynamic shortest paths.
+ * @param source the source vertex of the edge.
+ * @param destination the destination vertex of the edge.
+ * @param weight the weight of the edge (it must not be negative).
+ * @return true if the edge has been added, false otherwise.
+ */
+bool dynamicAddEdge(dynamicSSSP *d, int source, int destination, int weight);
+
+/**
+ * @brief Removes an edge from the graph and updates the shortest paths.
+ *
+ * @param d the dynamic shortest paths.
+ * @param source the source vertex of the edge.
+ * @param destination the destination vertex of the edge.
+ * @return true if the edge has been removed, false otherwise.
+ */
+bool dynamicRemoveEdge(dynamicSSSP *d, int source, int destination);
+
+/**
+ * @brief Sets the weight of an edge of the graph and updates the shortest paths.
+ *
+ * @param d the dynamic shortest paths.
+ * @param source the source vertex of the edge.
+ * @param destination the destination vertex of the edge.
+ * @param weight the new weight of the edge (it must not be negative).
+ * @return true if the weight has been set, false otherwise.
+ */
+bool dynamicSetEdgeWeight(dynamicSSSP *d, int source, int destination, int weight);
+
+/**
+ * @brief Destroys the dynamic shortest paths structure (the graph is not destroyed).
+ *
+ * @param d the dynamic shortest paths.
+ */
+void destroyDynamicSSSP(dynamicSSSP *d);
+
+/* DYNAMIC SHORTEST PATH - END */
+
+
+/* BATCH QUERIES - START */
+
+/**
+ * @enum queryType
+ * @brief The algorithm run by a query of a batch.
+ * @var queryType::BFS_QUERY
+ * Breadth-first-search: the distance is the number of edges.
+ * @var queryType::DIJKSTRA_QUERY
+ * Dijkstra shortest paths: the distance is the sum of the weights.
+ */
+enum queryType {BFS_QUERY, DIJKSTRA_QUERY};
+
+typedef struct graphQuery graphQuery;
+
+/**
+ * @struct graphQuery
+ * @brief This structure represents a query of a batch and its result.
+ * @var graphQuery::type
+ * The algorithm to run.
+ * @var graphQuery::source
+ * The vertex where to start the visit.
+ * @var graphQuery::target
+ * The vertex whose distance is wanted (the search stops when it is reached), -1 to get the whole visit.
+ * @var graphQuery::visit
+ * The result when target is -1: the same information of getBFS or the distances and parents of Dijkstra (NULL otherwise).
+ * @var graphQuery::distance
+ * The distance of the target (MAX_DISTANCE if it is not reachable).
+ * @var graphQuery::done
+ * Indicates if the query has been answered (false if a vertex doesn't exist or Dijkstra finds a negative weight).
+ */
+struct graphQuery {
+  enum queryType type;
+  int source;
+  int target;
+  visitInfo *visit;
+  int distance;
+  bool done;
+};
+
+/**
+ * @brief Runs a batch of independent queries on a graph that is not changed meanwhile.
+ *
+ * The queries are split among the threads of the pool (see setNumberOfThreads). Each chunk of queries reuses one
+ * workspace, which is reset only on the vertices touched by the previous query, so a query with a target costs
+ * only the part of the graph it explores. The results are written in the queries, in submission order.
+ *
+ * @param g the graph.
+ * @param queries the queries.
+ * @param nqueries the number of queries.
+ * @return the number of queries answered.
+ */
+int runQueryBatch(graph *g, graphQuery *queries, int nqueries);
+
+/* BATCH QUERIES - END */
+
+
+/* MULTI-SOURCE BFS - START */
+
+typedef struct bfsSummary bfsSummary;
+
+/**
+ * @struct bfsSummary
+ * @brief This structure represents the aggregate result of a breadth-first-search.
+ * @var bfsSummary::distanceSum
+ * The sum of the distances of the vertices reached from the source.
+ * @var bfsSummary::reached
+ * The number of vertices reached, including the source (0 if the source doesn't exist).
+ * @var bfsSummary::eccentricity
+ * The distance of the farthest vertex reached.
+ */
+struct bfsSummary {
+  long long distanceSum;
+  int reached;
+  int eccentricity;
+};
+
+/**
+ * @brief Performs a breadth-first-search from each of the sources at once.
+ *
+ * The sources are processed in batches of 64: each vertex keeps a 64-bit mask of the sources that have seen it and
+ * of the sources whose frontier contains it, so an edge is scanned once per level for the whole batch instead of
+ * once per source. The batches are split among the threads of the pool (see setNumberOfThreads).
+ *
+ * @param g the graph.
+ * @param sources the sources, NULL to start from every vertex of the graph.
+ * @param nsources the number of sources (ignored if sources is NULL).
+ * @return for each source, the array of the distances of the vertices (MAX_DISTANCE if not reachable).
+ */
+int ** getMultiSourceBFS(graph *g, int *sources, int nsources);
+
+/**
+ * @brief Like getMultiSourceBFS, but only the aggregates needed by closeness and eccentricity are kept.
+ *
+ * @param g the graph.
+ * @param sources the sources, NULL to start from every vertex of the graph.
+ * @param nsources the number of sources (ignored if sources is NULL).
+ * @return the summary of the visit of each source.
+ */
+bfsSummary * getMultiSourceBFSSummary(graph *g, int *sources, int nsources);
+
+/* MULTI-SOURCE BFS - END */
+
+
+/* CENTRALITY - START */
+
+/**
+ * @brief Computes the betweenness centrality of the vertices with the Brandes algorithm.
+ *
+ * Each source runs a single search that counts the shortest paths and then accumulates the dependencies of the
+ * vertices in reverse settle order. The sources are split among the threads of the pool (see setNumberOfThreads).
+ * The values are not normalized; for undirected graphs each path is counted once. When sampling, the dependencies
+ * of the sampled sources are scaled by the number of vertices over the number of samples.
+ *
+ * @param g the graph.
+ * @param weighted true to use the weights as lengths (Dijkstra), false to count the edges (breadth-first-search).
+ * @param samples the number of random sources for an approximate result, 0 to use every vertex.
+ * @param seed the seed of the sampling.
+ * @return the centrality of each vertex (returns NULL if weighted and there is a negative weight).
+ */
+double * getBetweennessCentrality(graph *g, bool weighted, int samples, unsigned int seed);
+
+/**
+ * @brief Computes the closeness centrality of the vertices, scaled by the fraction of vertices they reach.
+ *
+ * The closeness of a vertex reaching r vertices (itself included) out of n, at total distance d, is
+ * ((r - 1) / (n - 1)) * ((r - 1) / d), and 0 if it reaches no other vertex. The exact unweighted version uses
+ * getMultiSourceBFSSummary. When sampling, r and d are estimated from the distances to the sampled vertices.
+ *
+ * @param g the graph.
+ * @param weighted true to use the weights as lengths (Dijkstra), false to count the edges (breadth-first-search).
+ * @param samples the number of random vertices for an approximate result, 0 to use every vertex.
+ * @param seed the seed of the sampling.
+ * @return the centrality of each vertex (returns NULL if weighted and there is a negative weight).
+ */
+double * getClosenessCentrality(graph *g, bool weighted, int samples, unsigned int seed);
+
+/* CENTRALITY - END */
+
+
+/* PAGERANK - START */
+
+/**
+ * @brief Computes the PageRank of the vertices, ignoring the weights of the edges.
+ *
+ * The rank of the vertices without outgoing edges is spread uniformly. See getPersonalizedPageRank.
+ *
+ * @param g the graph.
+ * @param damping the probability of following an edge instead of jumping (usually 0.85).
+ * @param tolerance the iteration stops when the L1 distance between two consecutive rank vectors is below it.
+ * @param maxIterations the maximum number of iterations.
+ * @param iterations if not NULL, it will contain the number of iterations done.
+ * @return the rank of each vertex (the ranks sum to 1).
+ */
+double * getPageRank(graph *g, double damping, double tolerance, int maxIterations, int *iterations);
+
+/**
+ * @brief Computes the personalized PageRank of the vertices with a pull-based power iteration.
+ *
+ * The incoming edges are copied once in contiguous arrays; at each iteration every vertex pulls the rank of its
+ * in-neighbours divided by their out-degree, so the vertices are updated by the threads of the pool without
+ * synchronization (see setNumberOfThreads). The jumps, and the rank of the vertices without outgoing edges, go
+ * to the vertices in proportion to the personalization.
+ *
+ * @param g the graph.
+ * @param personalization the non-negative jump weight of each vertex (it is normalized), NULL for uniform.
+ * @param damping the probability of following an edge instead of jumping (usually 0.85).
+ * @param tolerance the iteration stops when the L1 distance between two consecutive rank vectors is below it.
+ * @param maxIterations the maximum number of iterations.
+ * @param iterations if not NULL, it will contain the number of iterations done.
+ * @return the rank of each vertex (returns NULL if a weight is negative or no vertex has a positive weight).
+ */
+double * getPersonalizedPageRank(graph *g, double *personalization, double damping, double tolerance, int maxIterations, int *iterations);
+
+/**
+ * @brief Approximates the PageRank personalized on a single vertex by pushing residuals (Andersen-Chung-Lang).
+ *
+ * Only the vertices whose residual exceeds epsilon times their out-degree are processed, so the work depends on
+ * epsilon and on the neighbourhood of the source, not on the size of the graph. For each vertex the result is at
+ * most the exact rank and at least the exact rank minus the residual left, which is below epsilon for each outgoing
+ * edge (or for each vertex without outgoing edges).
+ *
+ * @param g the graph.
+ * @param source the vertex on which the rank is personalized.
+ * @param damping the probability of following an edge instead of jumping back to the source.
+ * @param epsilon the residual threshold per outgoing edge.
+ * @param pushes if not NULL, it will contain the number of residuals pushed.
+ * @return the approximate rank of each vertex (returns NULL if the source doesn't exist).
+ */
+double * getPushPersonalizedPageRank(graph *g, int source, double damping, double epsilon, int *pushes);
+
+/* PAGERANK - END */
+
+
+/* TRIANGLES - START */
+
+/**
+ * @brief Counts the triangles of an undirected graph (self-loops are ignored).
+ *
+ * Each edge is oriented from the endpoint with lower degree to the one with higher degree (ties broken by index)
+ * and the oriented neighbours are stored sorted in contiguous arrays. Each triangle is then found once, intersecting
+ * the neighbours of the two endpoints of its lowest edge: the intersection is a merge, or a galloping search when a
+ * list is much longer than the other. The vertices are split among the threads of the pool (see setNumberOfThreads).
+ *
+ * @param g the graph.
+ * @param vertexTriangles if not NULL, it will contain the number of triangles each vertex belongs to (size values).
+ * @return the number of triangles (returns -1 if the graph is directed).
+ */
+long long getTriangleCount(graph *g, long long *vertexTriangles);
+
+/**
+ * @brief Computes the local clustering coefficient of the vertices of an undirected graph.
+ *
+ * The coefficient of a vertex with d neighbours (other than itself) that belongs to t triangles is
+ * 2t / (d (d - 1)), and 0 if d is less than 2.
+ *
+ * @param g the graph.
+ * @return the clustering coefficient of each vertex (returns NULL if the graph is directed).
+ */
+double * getClusteringCoefficients(graph *g);
+
+/**
+ * @brief Computes the transitivity (global clustering coefficient) of an undirected graph.
+ *
+ * The transitivity is three times the number of triangles over the number of paths of length two, and 0 if there
+ * are no such paths.
+ *
+ * @param g the graph.
+ * @return the transitivity (returns -1 if the graph is directed).
+ */
+double getTransitivity(graph *g);
+
+/* TRIANGLES - END */
+
+
+/* K-CORE - START */
+
+/**
+ * @brief Computes the core number of each vertex of an undirected graph with the Batagelj-Zaversnik algorithm.
+ *
+ * The vertices are bucket sorted by degree, then repeatedly the vertex of minimum current degree is removed and its
+ * neighbours are moved one bucket down, in O(V + E) time. Self-loops are ignored. The core number of a vertex is the
+ * largest k such that the vertex belongs to a subgraph where every vertex has at least k neighbours.
+ *
+ * @param g the graph.
+ * @param degeneracy if not NULL, it will contain the largest core number.
+ * @return the core number of each vertex (returns NULL if the graph is directed).
+ */
+int * getCoreNumbers(graph *g, int *degeneracy);
+
+/**
+ * @brief Extracts the k-core of an undirected graph: the subgraph induced by the vertices with core number at least k.
+ *
+ * @param g the graph.
+ * @param k the minimum core number.
+ * @param newId if not NULL, it will contain for each vertex of g its number in the k-core (-1 if it is not in it).
+ * It must be freed by the caller.
+ * @return the k-core, with the vertices renumbered in the same relative order (returns NULL if the graph is directed).
+ */
+graph * getKCore(graph *g, int k, int **newId);
+
+/* K-CORE - END */
+
+
+/* BICONNECTED COMPONENTS - START */
+
+typedef struct biconnectedComponents biconnectedComponents;
+
+/**
+ * @struct biconnectedComponents
+ * @brief This structure represents the biconnected components, the bridges and the articulation points of an undirected graph.
+ * @var biconnectedComponents::edges
+ * Each edge of the graph once, with source less than destination (self-loops are ignored).
+ * @var biconnectedComponents::component
+ * The biconnected component of each edge, from 0 to ncomponents - 1.
+ * @var biconnectedComponents::nedges
+ * The number of edges.
+ * @var biconnectedComponents::ncomponents
+ * The number of biconnected components.
+ * @var biconnectedComponents::bridges
+ * The edges whose removal disconnects their endpoints, with source less than destination.
+ * @var biconnectedComponents::nbridges
+ * The number of bridges.
+ * @var biconnectedComponents::articulationPoints
+ * The vertices whose removal increases the number of connected components, in increasing order.
+ * @var biconnectedComponents::narticulationPoints
+ * The number of articulation points.
+ */
+struct biconnectedComponents {
+  weightedEdge *edges;
+  int *component;
+  int nedges;
+  int ncomponents;
+  weightedEdge *bridges;
+  int nbridges;
+  int *articulationPoints;
+  int narticulationPoints;
+};
+
+/**
+ * @brief Computes the biconnected components, the bridges and the articulation points of an undirected graph.
+ *
+ * A single iterative depth-first-search (Hopcroft-Tarjan) computes the discovery time and the low-link of each vertex:
+ * the edges are pushed on a stack when they are first met, and popped as a component when the low-link of a child
+ * is not smaller than the discovery time of its parent. The time is O(V + E) and there is no recursion.
+ *
+ * @param g the graph.
+ * @return the biconnected components (returns NULL if the graph is directed).
+ */
+biconnectedComponents * getBiconnectedComponents(graph *g);
+
+/**
+ * @brief Destroys the biconnected components.
+ *
+ * @param b the biconnected components.
+ */
+void destroyBiconnectedComponents(biconnectedComponents *b);
+
+/* BICONNECTED COMPONENTS - END */
+
+
+/* MAXIMUM FLOW - START */
+
+typedef struct flowNetwork flowNetwork;
+
+/**
+ * @struct flowNetwork
+ * @brief This structure represents the residual graph of a directed graph whose weights are capacities.
+ *
+ * Each edge is stored as a forward arc and a paired reverse arc with capacity 0. The arcs leaving a vertex are
+ * contiguous, and the flow is antisymmetric: the flow of an arc is minus the flow of its twin.
+ * @var flowNetwork::offset
+ * The arcs leaving v are in [offset[v], offset[v+1]).
+ * @var flowNetwork::head
+ * The vertex each arc enters.
+ * @var flowNetwork::twin
+ * The paired arc of each arc.
+ * @var flowNetwork::edge
+ * The edge of each forward arc (-1 for the reverse arcs).
+ * @var flowNetwork::capacity
+ * The capacity of each arc.
+ * @var flowNetwork::flow
+ * The flow of each arc.
+ * @var flowNetwork::edges
+ * The edges of the graph, in the order of getEdges.
+ * @var flowNetwork::edgeArc
+ * The forward arc of each edge: the flow of edges[i] is flow[edgeArc[i]].
+ * @var flowNetwork::nedges
+ * The number of edges.
+ * @var flowNetwork::size
+ * The number of vertices.
+ * @var flowNetwork::source
+ * The source of the current flow (-1 if there is no flow yet).
+ * @var flowNetwork::sink
+ * The sink of the current flow (-1 if there is no flow yet).
+ * @var flowNetwork::value
+ * The value of the current flow.
+ * @var flowNetwork::level
+ * Work array: the distance of each vertex from the source in the residual graph.
+ * @var flowNetwork::current
+ * Work array: the next arc to try for each vertex.
+ * @var flowNetwork::queue
+ * Work array: the queue of the breadth-first-search.
+ * @var flowNetwork::path
+ * Work array: the arcs of the current augmenting path.
+ */
+struct flowNetwork {
+  size_t *offset;
+  int *head;
+  int *twin;
+  int *edge;
+  long long *capacity;
+  long long *flow;
+  weightedEdge *edges;
+  int *edgeArc;
+  int nedges;
+  int size;
+  int source;
+  int sink;
+  long long value;
+  int *level;
+  size_t *current;
+  int *queue;
+  int *path;
+};
+
+/**
+ * @brief Builds the residual graph of a directed graph, using the weights as capacities.
+ *
+ * @param g the graph.
+ * @return the flow network with no flow (returns NULL if the graph is undirected or a weight is negative).
+ */
+flowNetwork * initializeFlowNetwork(graph *g);
+
+/**
+ * @brief Computes a maximum flow with the Dinic algorithm.
+ *
+ * Each phase builds the BFS level graph of the residual graph and saturates it with an iterative blocking flow.
+ * If source and sink are the ones of the current flow, the computation starts from it (warm start after
+ * setFlowCapacity), otherwise the flow is reset first.
+ *
+ * @param f the flow network.
+ * @param source the source vertex.
+ * @param sink the sink vertex.
+ * @return the value of the maximum flow (returns -1 if a vertex doesn't exist or source is equal to sink).
+ */
+long long getMaxFlow(flowNetwork *f, int source, int sink);
+
+/**
+ * @brief Changes the capacity of an edge, keeping the current flow valid.
+ *
+ * If the edge carries more flow than the new capacity, the excess is sent back to the source and the missing flow
+ * is taken back from the sink along residual paths, so the flow value decreases and the next getMaxFlow with the
+ * same source and sink only has to find the new augmenting paths.
+ *
+ * @param f the flow network.
+ * @param source the source vertex of the edge.
+ * @param destination the destination vertex of the edge.
+ * @param capacity the new capacity.
+ * @return true if the capacity has been changed, false if the edge doesn't exist or the capacity is negative.
+ */
+bool setFlowCapacity(flowNetwork *f, int source, int destination, int capacity);
+
+/**
+ * @brief Returns the flow of an edge.
+ *
+ * @param f the flow network.
+ * @param source the source vertex of the edge.
+ * @param destination the destination vertex of the edge.
+ * @return the flow of the edge (returns -1 if the edge doesn't exist).
+ */
+long long getEdgeFlow(flowNetwork *f, int source, int destination);
+
+/**
+ * @brief Returns the minimum cut of the current maximum flow.
+ *
+ * The source side contains the vertices reachable from the source in the residual graph: the edges leaving it are
+ * saturated and their capacities sum to the flow value.
+ *
+ * @param f the flow network.
+ * @return for each vertex, true if it is on the source side (returns NULL if there is no flow yet).
+ */
+bool * getMinCut(flowNetwork *f);
+
+/**
+ * @brief Destroys the flow network.
+ *
+ * @param f the flow network.
+ */
+void destroyFlowNetwork(flowNetwork *f);
+
+/* MAXIMUM FLOW - END */
+
+
+/* VERTEX REORDERING - START */
+
+/**
+ * @enum vertexOrdering
+ * @brief The orderings that can be used to renumber the vertices of a graph.
+ * @var vertexOrdering::RCM_ORDER
+ * Reverse Cuthill-McKee: BFS from a vertex of minimum degree of each component, visiting the neighbours by increasing degree, then reversed.
+ * @var vertexOrdering::DEGREE_ORDER
+ * Vertices sorted by decreasing degree (the hubs get the first numbers).
+ * @var vertexOrdering::BFS_ORDER
+ * Vertices in BFS discovery order, one component after the other.
+ */
+enum vertexOrdering {RCM_ORDER, DEGREE_ORDER, BFS_ORDER};
+
+typedef struct vertexMap vertexMap;
+
+/**
+ * @struct vertexMap
+ * @brief This structure represents the renumbering of the vertices of a graph.
+ * @var vertexMap::newId
+ * The new number of each old vertex.
+ * @var vertexMap::oldId
+ * The old number of each new vertex.
+ * @var vertexMap::size
+ * The number of vertices.
+ */
+struct vertexMap {
+  int *newId;
+  int *oldId;
+  int size;
+};
+
+/**
+ * @brief Computes a permutation of the vertices that puts the neighbours close to each other.
+ *
+ * @param g the graph.
+ * @param ordering the ordering to use.
+ * @return the renumbering of the vertices (the graph is not changed).
+ */
+vertexMap * getVertexOrdering(graph *g, enum vertexOrdering ordering);
+
+/**
+ * @brief Renumbers the vertices of the graph with a locality improving ordering.
+ *
+ * The adjacency lists are moved to their new position and their nodes are allocated again in the new order,
+ * so the traversals walk the memory mostly forward.
+ *
+ * @param g the graph.
+ * @param ordering the ordering to use.
+ * @return the renumbering of the vertices, to translate the results back to the old numbers.
+ * @see translateVisit
+ */
+vertexMap * reorderGraph(graph *g, enum vertexOrdering ordering);
+
+/**
+ * @brief Translates the visit information of a reordered graph back to the old vertex numbers.
+ *
+ * @param visit the visit information computed on the reordered graph.
+ * @param map the renumbering returned by reorderGraph.
+ * @return the visit information indexed by the old vertex numbers (the input visit is not changed).
+ */
+visitInfo * translateVisit(visitInfo *visit, vertexMap *map);
+
+/**
+ * @brief Destroys the vertex map structure.
+ *
+ * @param map the vertex map.
+ */
+void destroyVertexMap(vertexMap *map);
+
+/* VERTEX REORDERING - END */
+
+
+/* COMPRESSED GRAPH - START */
+
+typedef struct compressedGraph compressedGraph;
+
+/**
+ * @struct compressedGraph
+ * @brief This structure represents a read-only copy of a graph with compressed adjacency lists.
+ *
+ * The neighbours of each vertex are sorted: the first one is stored as its (zigzag) difference from the vertex
+ * and the others as the gap from the previous neighbour, each in a variable-length code of 7 bits per byte.
+ * The weights are stored apart, in the same order of the neighbours.
+ * @var compressedGraph::data
+ * The encoded neighbours of all the vertices.
+ * @var compressedGraph::dataOffset
+ * The position in data of the neighbours of each vertex (size+1 values).
+ * @var compressedGraph::edgeOffset
+ * The number of edges before each vertex (size+1 values): the degree of v is edgeOffset[v+1] - edgeOffset[v].
+ * @var compressedGraph::weights
+ * The weights of the edges (NULL if all the weights are DEFAULT_EDGE_WEIGHT).
+ * @var compressedGraph::size
+ * The number of vertices.
+ * @var compressedGraph::directed
+ * Indicates if the graph is directed or not.
+ */
+struct compressedGraph {
+  unsigned char *data;
+  size_t *dataOffset;
+  size_t *edgeOffset;
+  int *weights;
+  int size;
+  bool directed;
+};
+
+typedef struct compressedIterator compressedIterator;
+
+/**
+ * @struct compressedIterator
+ * @brief This structure represents the position of a walk over the neighbours of a vertex of a compressed graph.
+ * @see compressedBegin
+ * @var compressedIterator::position
+ * The next byte to decode.
+ * @var compressedIterator::weight
+ * The weight of the next neighbour (NULL if all the weights are DEFAULT_EDGE_WEIGHT).
+ * @var compressedIterator::remaining
+ * The number of neighbours still to decode.
+ * @var compressedIterator::current
+ * The last decoded neighbour.
+ * @var compressedIterator::first
+ * Indicates if the next neighbour is the first one.
+ */
+struct compressedIterator {
+  const unsigned char *position;
+  const int *weight;
+  size_t remaining;
+  int current;
+  bool first;
+};
+
+/**
+ * @brief Builds the compressed copy of a graph (the graph is not changed).
+ *
+ * @param g the graph.
+ * @return the compressed graph.
+ */
+compressedGraph * compressGraph(graph *g);
+
+/**
+ * @brief Gets the number of bytes used by a compressed graph.
+ *
+ * @param c the compressed graph.
+ * @return the number of bytes.
+ */
+size_t getCompressedGraphBytes(compressedGraph *c);
+
+/**
+ * @brief Gets the number of neighbours of a vertex of a compressed graph.
+ *
+ * @param c the compressed graph.
+ * @param vertex the vertex.
+ * @return the number of neighbours.
+ */
+static inline int getCompressedDegree(compressedGraph *c, int vertex) {
+  return (int) (c->edgeOffset[vertex+1] - c->edgeOffset[vertex]);
+}
+
+/**
+ * @brief Starts a walk over the neighbours of a vertex of a compressed graph.
+ *
+ * @param c the compressed graph.
+ * @param vertex the vertex.
+ * @param it the iterator to initialize.
+ */
+static inline void compressedBegin(compressedGraph *c, int vertex, compressedIterator *it) {
+  it->position = c->data + c->dataOffset[vertex];
+  it->weight = c->weights != NULL ? c->weights + c->edgeOffset[vertex] : NULL;
+  it->remaining = c->edgeOffset[vertex+1] - c->edgeOffset[vertex];
+  it->current = vertex;
+  it->first = true;
+}
+
+/**
+ * @brief Decodes the next neighbour of a walk started with compressedBegin. The neighbours come in increasing order.
+ *
+ * @param it the iterator.
+ * @param vertex it will contain the neighbour.
+ * @param weight it will contain the weight of the edge.
+ * @return true if a neighbour has been decoded, false if there are no more neighbours.
+ */
+static inline bool compressedNext(compressedIterator *it, int *vertex, int *weight) {
+  unsigned int value = 0;
+  unsigned int byte;
+  int shift = 0;
+
+  if(it->remaining == 0) return false;
+
+  do {
+    byte = *it->position++;
+    value |= (byte & 0x7F) << shift;
+    shift += 7;
+  } while(byte & 0x80);
+
+  if(it->first) {
+    it->current += (int) (value >> 1) ^ -(int) (value & 1);
+    it->first = false;
+  } else {
+    it->current += (int) value;
+  }
+  it->remaining -= 1;
+
+  *vertex = it->current;
+  *weight = it->weight != NULL ? *it->weight++ : DEFAULT_EDGE_WEIGHT;
+  return true;
+}
+
+/**
+ * @brief Destroys the compressed graph structure.
+ *
+ * @param c the compressed graph.
+ */
+void destroyCompressedGraph(compressedGraph *c);
+
+/* COMPRESSED GRAPH - END */
+
+
+/* NEIGHBOUR ITERATION - START */
+
+typedef struct listIterator listIterator;
+
+/**
+ * @struct listIterator
+ * @brief This structure represents the position of a walk over the adjacency list of a vertex of a graph.
+ * @see listBegin
+ * @var listIterator::node
+ * The next node of the adjacency list.
+ */
+struct listIterator {
+  edgenode *node;
+};
+
+/**
+ * @brief Starts a walk over the neighbours of a vertex of a graph.
+ *
+ * @param g the graph.
+ * @param vertex the vertex.
+ * @param it the iterator to initialize.
+ */
+static inline void listBegin(graph *g, int vertex, listIterator *it) {
+  it->node = g->adjList[vertex];
+}
+
+/**
+ * @brief Gets the next neighbour of a walk started with listBegin. The neighbours come in the order of the adjacency list.
+ *
+ * @param it the iterator.
+ * @param vertex it will contain the neighbour.
+ * @param weight it will contain the weight of the edge.
+ * @return true if there was a neighbour, false if there are no more neighbours.
+ */
+static inline bool listNext(listIterator *it, int *vertex, int *weight) {
+  if(it->node == NULL) return false;
+
+  *vertex = it->node->edge;
+  *weight = it->node->weight;
+  it->node = it->node->next;
+  return true;
+}
+
+/**
+ * @brief Starts a walk over the incoming edges of a vertex of a graph (see getIncomingEdges).
+ *
+ * @param g the graph.
+ * @param vertex the vertex.
+ * @param it the iterator to initialize.
+ */
+static inline void incomingBegin(graph *g, int vertex, listIterator *it) {
+  it->node = g->directed ? g->inAdjList[vertex] : g->adjList[vertex];
+}
+
+typedef struct csrGraph csrGraph;
+
+/**
+ * @struct csrGraph
+ * @brief This structure represents a read-only copy of a graph with the adjacency lists in contiguous arrays.
+ * @var csrGraph::offset
+ * The position of the neighbours of each vertex (size+1 values): the neighbours of v are in [offset[v], offset[v+1]).
+ * @var csrGraph::target
+ * The neighbours of all the vertices.
+ * @var csrGraph::weight
+ * The weights of the edges, in the same order of target.
+ * @var csrGraph::size
+ * The number of vertices.
+ * @var csrGraph::directed
+ * Indicates if the graph is directed or not.
+ */
+struct csrGraph {
+  size_t *offset;
+  int *target;
+  int *weight;
+  int size;
+  bool directed;
+};
+
+typedef struct csrIterator csrIterator;
+
+/**
+ * @struct csrIterator
+ * @brief This structure represents the position of a walk over the neighbours of a vertex of a CSR graph.
+ * @see csrBegin
+ * @var csrIterator::target
+ * The next neighbour.
+ * @var csrIterator::weight
+ * The weight of the next neighbour.
+ * @var csrIterator::end
+ * The end of the neighbours of the vertex.
+ */
+struct csrIterator {
+  const int *target;
+  const int *weight;
+  const int *end;
+};
+
+/**
+ * @brief Builds the CSR copy of a graph (the graph is not changed). The neighbours keep the order of the adjacency lists.
+ *
+ * @param g the graph.
+ * @return the CSR graph.
+ */
+csrGraph * getCSRGraph(graph *g);
+
+/**
+ * @brief Starts a walk over the neighbours of a vertex of a CSR graph.
+ *
+ * @param c the CSR graph.
+ * @param vertex the vertex.
+ * @param it the iterator to initialize.
+ */
+static inline void csrBegin(csrGraph *c, int vertex, csrIterator *it) {
+  it->target = c->target + c->offset[vertex];
+  it->weight = c->weight + c->offset[vertex];
+  it->end = c->target + c->offset[vertex+1];
+}
+
+/**
+ * @brief Gets the next neighbour of a walk started with csrBegin.
+ *
+ * @param it the iterator.
+ * @param vertex it will contain the neighbour.
+ * @param weight it will contain the weight of the edge.
+ * @return true if there was a neighbour, false if there are no more neighbours.
+ */
+static inline bool csrNext(csrIterator *it, int *vertex, int *weight) {
+  if(it->target == it->end) return false;
+
+  *vertex = *it->target++;
+  *weight = *it->weight++;
+  return true;
+}
+
+/**
+ * @brief Destroys the CSR graph structure.
+ *
+ * @param c the CSR graph.
+ */
+void destroyCSRGraph(csrGraph *c);
+
+/**
+ * @brief Declares the algorithms written over the neighbour iterators, for the storage named NAME of type GRAPH.
+ *
+ * Each storage has its own copy of the algorithms, with begin and next inlined, so there is no indirect call per edge:
+ * - get<NAME>BFS(g, startingVertex): breadth-first-search, the distance is the number of edges from startingVertex
+ * - get<NAME>DFS(g, startingVertex): depth-first-search without recursion, with the same times of getDFS
+ * - get<NAME>DijkstraShortestPaths(g, startingVertex): Dijkstra over a binary heap (NULL on negative weights)
+ * - get<NAME>ConnectedComponents(g): connected components of an undirected graph, in the order of getConnectedComponents
+ *
+ * The visits return NULL if startingVertex is not a vertex of the graph.
+ */
+#define DECLARE_NEIGHBOUR_ALGORITHMS(NAME, GRAPH) \
+  visitInfo * get##NAME##BFS(GRAPH *g, int startingVertex); \
+  visitInfo * get##NAME##DFS(GRAPH *g, int startingVertex); \
+  visitInfo * get##NAME##DijkstraShortestPaths(GRAPH *g, int startingVertex); \
+  lists * get##NAME##ConnectedComponents(GRAPH *g);
+
+DECLARE_NEIGHBOUR_ALGORITHMS(List, graph)
+DECLARE_NEIGHBOUR_ALGORITHMS(CSR, csrGraph)
+DECLARE_NEIGHBOUR_ALGORITHMS(Compressed, compressedGraph)
+
+/* NEIGHBOUR ITERATION - END */
+
+
+/* CONCURRENT SNAPSHOTS - START */
+
+typedef struct graphSnapshot graphSnapshot;
+
+/**
+ * @struct graphSnapshot
+ * @brief This structure represents a published version of a concurrent graph.
+ *
+ * The adjacency lists of a version are never changed, so any read-only algorithm can run on the graph of a snapshot
+ * (for example getBFS(&snapshot->g, 0)) while the writers prepare and publish newer versions.
+ * @see acquireSnapshot
+ * @var graphSnapshot::g
+ * The read-only graph of this version.
+ * @var graphSnapshot::version
+ * The number of the version (the first one is 0).
+ * @var graphSnapshot::readers
+ * The number of readers that hold the snapshot.
+ * @var graphSnapshot::retired
+ * The nodes of this version that are not in the next one: they are freed with the snapshot.
+ * @var graphSnapshot::nretired
+ * The number of retired nodes.
+ * @var graphSnapshot::newer
+ * The next version (NULL for the current version).
+ */
+struct graphSnapshot {
+  graph g;
+  long version;
+  int readers;
+  edgenode **retired;
+  int nretired;
+  graphSnapshot *newer;
+};
+
+typedef struct concurrentGraph concurrentGraph;
+
+/**
+ * @struct concurrentGraph
+ * @brief This structure represents a graph shared by many readers and changed by writers through versioned snapshots.
+ *
+ * The writers change a private version of the adjacency lists with copy-on-write: a new edge is put in front of the
+ * list, a changed or removed edge copies the nodes before it and shares the rest of the list. The changes become
+ * visible to the readers only when they are published. A snapshot, with the nodes that left the lists after it, is
+ * freed when it is not the current one and neither it nor an older snapshot is held by a reader.
+ * @var concurrentGraph::g
+ * The private version of the writers.
+ * @var concurrentGraph::current
+ * The last published snapshot.
+ * @var concurrentGraph::oldest
+ * The oldest snapshot that is not freed yet.
+ * @var concurrentGraph::pending
+ * The nodes that left the lists of the writers after the last publication.
+ * @var concurrentGraph::npending
+ * The number of pending nodes.
+ * @var concurrentGraph::pendingCapacity
+ * The capacity of the pending array.
+ * @var concurrentGraph::snapshotLock
+ * It protects the list of the snapshots and their readers (it is never held while an algorithm runs).
+ * @var concurrentGraph::writerLock
+ * It serializes the writers.
+ */
+struct concurrentGraph {
+  graph *g;
+  graphSnapshot *current;
+  graphSnapshot *oldest;
+  edgenode **pending;
+  int npending;
+  int pendingCapacity;
+  pthread_mutex_t snapshotLock;
+  pthread_mutex_t writerLock;
+};
+
+/**
+ * @brief Initializes a concurrent graph with a copy of a graph (the graph is not changed) and publishes version 0.
+ * The removed vertices of a graph with lazy removal stay removed in the copy and in the snapshots.
+ *
+ * @param g the graph.
+ * @return the concurrent graph.
+ */
+concurrentGraph * initializeConcurrentGraph(graph *g);
+
+/**
+ * @brief Gets the current snapshot. It stays valid, and it is never changed, until it is released.
+ *
+ * @param cg the concurrent graph.
+ * @return the snapshot.
+ */
+graphSnapshot * acquireSnapshot(concurrentGraph *cg);
+
+/**
+ * @brief Releases a snapshot taken with acquireSnapshot.
+ *
+ * @param cg the concurrent graph.
+ * @param snapshot the snapshot.
+ */
+void releaseSnapshot(concurrentGraph *cg, graphSnapshot *snapshot);
+
+/**
+ * @brief Adds vertices to the private version of the writers.
+ *
+ * @param cg the concurrent graph.
+ * @param n the number of vertices to add.
+ * @return true if the vertices have been added, false otherwise.
+ */
+bool concurrentAddVertex(concurrentGraph *cg, int n);
+
+/**
+ * @brief Adds an edge to the private version of the writers.
+ *
+ * @param cg the concurrent graph.
+ * @param source the source vertex of the edge.
+ * @param destination the destination vertex of the edge.
+ * @param weight the weight of the edge.
+ * @return true if the edge has been added, false otherwise.
+ */
+bool concurrentAddEdge(concurrentGraph *cg, int source, int destination, int weight);
+
+/**
+ * @brief Removes an edge from the private version of the writers.
+ *
+ * @param cg the concurrent graph.
+ * @param source the source vertex of the edge.
+ * @param destination the destination vertex of the edge.
+ * @return true if the edge has been removed, false otherwise.
+ */
+bool concurrentRemoveEdge(concurrentGraph *cg, int source, int destination);
+
+/**
+ * @brief Changes the weight of an edge in the private version of the writers.
+ *
+ * @param cg the concurrent graph.
+ * @param source the source vertex of the edge.
+ * @param destination the destination vertex of the edge.
+ * @param weight the new weight.
+ * @return true if the weight has been changed, false otherwise.
+ */
+bool concurrentSetEdgeWeight(concurrentGraph *cg, int source, int destination, int weight);
+
+/**
+ * @brief Publishes the changes of the writers as a new snapshot. The readers that hold an older snapshot are not
+ * blocked and keep seeing their version. It costs O(V) to copy the list heads, so changes should be published in batches.
+ *
+ * @param cg the concurrent graph.
+ * @return the version of the new snapshot.
+ */
+long publishSnapshot(concurrentGraph *cg);
+
+/**
+ * @brief Destroys the concurrent graph structure (no snapshot must be held).
+ *
+ * @param cg the concurrent graph.
+ */
+void destroyConcurrentGraph(concurrentGraph *cg);
+
+/* CONCURRENT SNAPSHOTS - END */
+
+
 /* DEALLOCATING - START */
 
 /**
@@ -7,6 +7,91 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdatomic.h>
+
+
+/* STATISTICS - START */
+
+/**
+ * @enum statsPhase
+ * @brief The phases of an algorithm call that are timed when the statistics are enabled.
+ * @var statsPhase::STATS_INITIALIZATION
+ * Allocation and initialization of the working structures.
+ * @var statsPhase::STATS_SEARCH
+ * The main loop of the algorithm.
+ * @var statsPhase::STATS_PHASES
+ * The number of phases.
+ */
+enum statsPhase {STATS_INITIALIZATION, STATS_SEARCH, STATS_PHASES};
+
+typedef struct graphStats graphStats;
+
+/**
+ * @struct graphStats
+ * @brief This structure represents the counters and the timers of the instrumented algorithms.
+ *
+ * The counters are updated only if the library is compiled with GRAPH_STATS defined (make STATS=1), otherwise
+ * the instrumentation is removed at compile time. Each thread has its own counters: the work done by the
+ * threads of the parallel algorithms is not counted.
+ * @var graphStats::edgesScanned
+ * The number of edges looked at.
+ * @var graphStats::verticesSettled
+ * The number of vertices whose visit has been completed.
+ * @var graphStats::heapOperations
+ * The number of operations on priority queues and heaps.
+ * @var graphStats::relaxations
+ * The number of distances improved.
+ * @var graphStats::allocations
+ * The number of memory allocations.
+ * @var graphStats::bytesAllocated
+ * The number of bytes allocated.
+ * @var graphStats::phaseTime
+ * The time spent in each phase, in nanoseconds.
+ */
+struct graphStats {
+  long long edgesScanned;
+  long long verticesSettled;
+  long long heapOperations;
+  long long relaxations;
+  long long allocations;
+  long long bytesAllocated;
+  long long phaseTime[STATS_PHASES];
+};
+
+#ifdef GRAPH_STATS
+extern _Thread_local graphStats currentStats;
+extern _Thread_local long long currentPhaseStart[STATS_PHASES];
+#define STATS_ADD(field, n) (currentStats.field += (n))
+#define STATS_ALLOC(bytes) (currentStats.allocations += 1, currentStats.bytesAllocated += (long long) (bytes))
+#define STATS_PHASE_START(phase) (currentPhaseStart[phase] = getStatsTime())
+#define STATS_PHASE_END(phase) (currentStats.phaseTime[phase] += getStatsTime() - currentPhaseStart[phase])
+#else
+#define STATS_ADD(field, n) ((void) 0)
+#define STATS_ALLOC(bytes) ((void) 0)
+#define STATS_PHASE_START(phase) ((void) 0)
+#define STATS_PHASE_END(phase) ((void) 0)
+#endif
+
+/**
+ * @brief Gets the statistics collected by the calling thread since the last reset.
+ *
+ * @return the statistics (all zeros if the library is compiled without GRAPH_STATS).
+ */
+graphStats getGraphStats();
+
+/**
+ * @brief Resets the statistics of the calling thread. It is called before an algorithm to get the statistics of that call.
+ */
+void resetGraphStats();
+
+/**
+ * @brief Gets the time of a monotonic clock used by the phase timers.
+ *
+ * @return the time in nanoseconds.
+ */
+long long getStatsTime();
+
+/* STATISTICS - END */
 
 
 /* QUEUE - START */
@@ -107,6 +192,81 @@ void destroyQueue(queue *q);
 /* QUEUE - END */
 
 
+/* HEAP - START */
+
+typedef struct heapnode heapnode;
+
+/**
+ * @struct heapnode
+ * @brief This structure represents a node in a heap.
+ * @see heap
+ * @var heapnode::value
+ * The value of the node.
+ * @var heapnode::priority
+ * The priority of the node.
+ */
+struct heapnode {
+  int value;
+  int priority;
+};
+
+typedef struct heap heap;
+
+/**
+ * @struct heap
+ * @brief This structure represents a binary min-heap stored in a contiguous array.
+ *
+ * There is no decrease-key operation: a value is pushed again with the new priority and the stale copies
+ * are skipped by the caller when they are popped.
+ * @var heap::nodes
+ * The nodes of the heap.
+ * @var heap::size
+ * Number of elements in the heap.
+ * @var heap::capacity
+ * Number of elements that fit in nodes before it is grown.
+ */
+struct heap {
+  heapnode *nodes;
+  int size;
+  int capacity;
+};
+
+/**
+ * @brief Initializes the heap structure.
+ *
+ * @param capacity the initial capacity of the heap.
+ * @return the heap.
+ */
+heap * initializeHeap(int capacity);
+
+/**
+ * @brief Pushes a value in the heap with the given priority.
+ *
+ * @param h the heap.
+ * @param value the value to push.
+ * @param priority the priority of the value.
+ */
+void heapPush(heap *h, int value, int priority);
+
+/**
+ * @brief Pops the value with minimum priority value.
+ *
+ * @param h the heap.
+ * @param priority if not NULL, it will contain the priority of the popped value.
+ * @return the popped value (returns -1 if the heap is empty).
+ */
+int heapPop(heap *h, int *priority);
+
+/**
+ * @brief Destroys the heap structure.
+ *
+ * @param h the heap.
+ */
+void destroyHeap(heap *h);
+
+/* HEAP - END */
+
+
 /* LIST OF LINKED-LIST - START */
 
 typedef struct listnode listnode;
@@ -228,7 +388,7 @@ k_union_find *initializeKUnionFind(int size);
 void k_union(k_union_find *kunion, int a, int b);
 
 /**
- * @brief Gets the parent of the given element in the k-union-find.
+ * @brief Gets the root of the given element in the k-union-find, halving the path on the way.
  *
  * @param kunion the k-union-find.
  * @param a the element.
@@ -246,6 +406,200 @@ void destroyKUnionFind(k_union_find *kunion);
 /* K-UNION-FIND - END */
 
 
+/* C-UNION-FIND - START */
+
+typedef struct c_union_find c_union_find;
+
+/**
+ * @struct c_union_find
+ * @brief This structure represents a lock-free union find that can be shared by many threads.
+ *
+ * The roots are always linked under the root with the smaller index, so a parent pointer can only decrease
+ * and every update is a single compare-and-swap on the parent array.
+ * @var c_union_find::parent
+ * The parent of each node.
+ * @var c_union_find::size
+ * The number of node.
+ */
+struct c_union_find {
+  atomic_int *parent;
+  int size;
+};
+
+/**
+ * @brief Initializes the c-union-find structure.
+ *
+ * @param size the number of makeSet in the c-union-find.
+ * @return the c-union-find.
+ */
+c_union_find *initializeCUnionFind(int size);
+
+/**
+ * @brief Performs the union of two element in the c-union-find. It is safe to call it from many threads.
+ *
+ * @param cunion the c-union-find.
+ * @param a the first element.
+ * @param b the second element.
+ * @return true if two different sets have been merged, false otherwise.
+ */
+bool c_union(c_union_find *cunion, int a, int b);
+
+/**
+ * @brief Gets the root of the given element in the c-union-find, halving the path on the way. It is safe to call it from many threads.
+ *
+ * @param cunion the c-union-find.
+ * @param a the element.
+ * @return the root of the given element.
+ */
+int c_find(c_union_find *cunion, int a);
+
+/**
+ * @brief Destroys the c-union-find structure.
+ *
+ * @param cunion the c-union-find.
+ */
+void destroyCUnionFind(c_union_find *cunion);
+
+/* C-UNION-FIND - END */
+
+
+/* PARALLEL - START */
+
+/**
+ * @brief Gets the number of threads used by the parallel algorithms (by default the number of online processors).
+ *
+ * @return the number of threads.
+ */
+int getNumberOfThreads();
+
+/**
+ * @brief Sets the number of threads used by the parallel algorithms. With a single thread the work is run in the calling thread.
+ *
+ * The parallel work runs on a shared pool of n-1 workers plus the calling thread, each one with its own deque of tasks:
+ * a thread that runs out of tasks steals from the others. The pool is started by the first parallel call and restarted
+ * when the number changes, so it must not be changed while a parallel call runs.
+ *
+ * @param n the number of threads (values lower than 1 are treated as 1).
+ */
+void setNumberOfThreads(int n);
+
+/**
+ * @brief Gets the index of the pool worker that runs the calling code.
+ *
+ * @return the index of the worker (from 1 to getNumberOfThreads()-1), 0 for a thread outside of the pool.
+ */
+int getWorkerId();
+
+/**
+ * @brief Splits the range [start, end) in contiguous chunks and runs fun on each chunk in parallel. It returns when all the chunks are done.
+ *
+ * The range can be of vertices, edges or any other index: about four chunks per thread are made, to balance the load.
+ *
+ * @param start the first index of the range.
+ * @param end the index after the last one of the range.
+ * @param fun the function to call on each chunk [chunkStart, chunkEnd).
+ * @param arg the argument passed to fun.
+ */
+void parallelFor(int start, int end, void (*fun)(int chunkStart, int chunkEnd, void *arg), void *arg);
+
+/**
+ * @brief Like parallelFor, but the range is halved until the chunks are not bigger than grain.
+ *
+ * With a single thread, or a range not bigger than grain, fun is called once on the whole range in the calling thread.
+ *
+ * @param start the first index of the range.
+ * @param end the index after the last one of the range.
+ * @param grain the maximum size of a chunk.
+ * @param fun the function to call on each chunk [chunkStart, chunkEnd).
+ * @param arg the argument passed to fun.
+ */
+void parallelForGrain(int start, int end, int grain, void (*fun)(int chunkStart, int chunkEnd, void *arg), void *arg);
+
+typedef struct workerBuffer workerBuffer;
+
+/**
+ * @struct workerBuffer
+ * @brief This structure represents a zeroed buffer reserved to a thread while it is acquired.
+ * @var workerBuffer::data
+ * The buffer (NULL until it is acquired the first time).
+ * @var workerBuffer::busy
+ * Indicates if the buffer is acquired.
+ * @var workerBuffer::next
+ * The next extra buffer.
+ */
+struct workerBuffer {
+  void *data;
+  atomic_bool busy;
+  workerBuffer *next;
+};
+
+typedef struct workerBuffers workerBuffers;
+
+/**
+ * @struct workerBuffers
+ * @brief This structure represents the buffers where the chunks of a parallel call accumulate their partial results.
+ *
+ * Each thread of the pool reuses its own buffer for all the chunks it runs, so the memory is proportional to the number
+ * of threads and not to the number of chunks. A nested call, or a second thread outside of the pool, gets an extra buffer.
+ * @var workerBuffers::threads
+ * The buffer of each thread, indexed by getWorkerId.
+ * @var workerBuffers::nthreads
+ * The number of threads.
+ * @var workerBuffers::extra
+ * The extra buffers (they are never removed until the structure is destroyed).
+ * @var workerBuffers::bytes
+ * The size of each buffer.
+ */
+struct workerBuffers {
+  workerBuffer *threads;
+  int nthreads;
+  _Atomic(workerBuffer *) extra;
+  size_t bytes;
+};
+
+/**
+ * @brief Initializes the worker buffers, one for each thread of the current number of threads.
+ *
+ * @param bytes the size of each buffer.
+ * @return the worker buffers.
+ */
+workerBuffers * initializeWorkerBuffers(size_t bytes);
+
+/**
+ * @brief Acquires a zeroed buffer for the calling thread: the buffer of its worker when it is free, an extra one otherwise.
+ *
+ * @param buffers the worker buffers.
+ * @return the buffer (it keeps what has been accumulated in it by the previous chunks).
+ */
+void * acquireWorkerBuffer(workerBuffers *buffers);
+
+/**
+ * @brief Releases a buffer acquired with acquireWorkerBuffer.
+ *
+ * @param buffers the worker buffers.
+ * @param data the buffer.
+ */
+void releaseWorkerBuffer(workerBuffers *buffers, void *data);
+
+/**
+ * @brief Gets the buffers that have been acquired at least once. It must be called when the parallel call is done.
+ *
+ * @param buffers the worker buffers.
+ * @param n it will contain the number of buffers.
+ * @return the array of the buffers (it must be freed by the caller).
+ */
+void ** getWorkerBuffers(workerBuffers *buffers, int *n);
+
+/**
+ * @brief Destroys the worker buffers and their data.
+ *
+ * @param buffers the worker buffers.
+ */
+void destroyWorkerBuffers(workerBuffers *buffers);
+
+/* PARALLEL - END */
+
+
 /* COMPARE FUNCTIONS - START */
 
 /**
@@ -256,7 +610,7 @@ void destroyKUnionFind(k_union_find *kunion);
 int compareFunUtil1(const void *a, const void *b);
 
 /**
- * @brief Compare function used in getKruskalMST to get the ascending order of an array.
+ * @brief Compare function to get the ascending order of an array of edges by weight.
  *
  * @see qsort
  */
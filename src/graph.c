@@ -4,6 +4,8 @@
  * @date August 9, 2021
  */
 
+#include <limits.h>
+#include <stdint.h>
 #include "../include/graph.h"
 
 
@@ -14,6 +16,12 @@ graph * initializeGraph(bool directed) {
   g->size = 0;
   g->directed = directed;
   g->adjList = NULL;
+  g->lazyRemoval = false;
+  g->removed = NULL;
+  g->removedCount = 0;
+  g->connectivity = NULL;
+  g->inAdjList = NULL;
+  g->view = false;
 
   return g;
 }
@@ -41,13 +49,18 @@ void printGraph(graph *g) {
 }
 
 visitInfo * initializeVisit(graph *g) {
+  return initializeVisitSize(g->size);
+}
+
+visitInfo * initializeVisitSize(int size) {
   visitInfo *visit = (visitInfo *) malloc(sizeof(visitInfo));
-  visit->startTime = (int *) malloc(sizeof(int) * g->size);
-  visit->endTime = (int *) malloc(sizeof(int) * g->size);
-  visit->parent = (int *) malloc(sizeof(int) * g->size);
-  visit->distance = (int *) malloc(sizeof(int) * g->size);
-  visit->color = (enum color *) malloc(sizeof(enum color) * g->size);
-  for(int i = 0; i < g->size; i++) {
+  visit->startTime = (int *) malloc(sizeof(int) * size);
+  visit->endTime = (int *) malloc(sizeof(int) * size);
+  visit->parent = (int *) malloc(sizeof(int) * size);
+  visit->distance = (int *) malloc(sizeof(int) * size);
+  visit->color = (enum color *) malloc(sizeof(enum color) * size);
+  STATS_ALLOC(sizeof(visitInfo) + (sizeof(int) * 4 + sizeof(enum color)) * size);
+  for(int i = 0; i < size; i++) {
     visit->startTime[i] = -1;
     visit->endTime[i] = -1;
     visit->parent[i] = -1;
@@ -79,23 +92,159 @@ bool addVertex(graph *g, int n) {
     }
   }
 
+  if(g->inAdjList != NULL) {
+    g->inAdjList = (edgenode **) realloc(g->inAdjList, sizeof(edgenode *) * (g->size + 1));
+    for(int i = g->size - n; i < g->size; i++) {
+      g->inAdjList[i] = NULL;
+    }
+  }
+
+  if(g->removed != NULL) {
+    g->removed = (bool *) realloc(g->removed, sizeof(bool) * g->size);
+    for(int i = g->size - n; i < g->size; i++) {
+      g->removed[i] = false;
+    }
+  }
+
+  if(g->connectivity != NULL) {
+    connectivityAddVertices(g, n);
+  }
+
   return true;
 }
 
 bool containsVertex(graph *g, int vertex) {
-  if(vertex >= 0 && vertex < g->size) {
+  if(vertex >= 0 && vertex < g->size && (g->removed == NULL || !g->removed[vertex])) {
     return true;
   } else {
     return false;
   }
 }
 
+/**
+ * The number of vertices that exist (the tombstones are left out, whether lazy removal is still enabled or not).
+ */
+static int countVertices(graph *g) {
+  return g->size - g->removedCount;
+}
+
+/**
+ * Removes the first node of the list that points to the vertex.
+ */
+static bool unlinkNode(edgenode **link, int vertex) {
+  edgenode *temp = NULL;
+
+  while(*link != NULL && (*link)->edge != vertex) {
+    link = &(*link)->next;
+  }
+  if(*link == NULL) return false;
+
+  temp = *link;
+  *link = temp->next;
+  free(temp);
+  return true;
+}
+
+/**
+ * Removes the nodes of the list that point to the removed vertex and shifts down the greater vertices.
+ */
+static void unlinkAndRenumber(edgenode **link, int vertex) {
+  edgenode *temp = NULL;
+
+  while(*link != NULL) {
+    if((*link)->edge == vertex) {
+      temp = *link;
+      *link = temp->next;
+      free(temp);
+    } else {
+      if((*link)->edge > vertex) {
+        (*link)->edge -= 1;
+      }
+      link = &(*link)->next;
+    }
+  }
+}
+
+/**
+ * Removes the edges that point to the vertex. For an undirected graph only the adjacency lists of the neighbours
+ * are walked, for a directed graph with the reverse index only the lists of the predecessors and the incoming lists
+ * of the successors are walked, otherwise all the adjacency lists are walked (but nothing is renumbered or moved).
+ */
+static void removeIncomingEdges(graph *g, int vertex) {
+  edgenode **link = NULL;
+  edgenode *temp = NULL;
+  edgenode *adj = NULL;
+
+  if(!g->directed) {
+    // The self-loops are skipped: they are in the list of the vertex, which is destroyed by the caller
+    adj = g->adjList[vertex];
+    while(adj != NULL) {
+      if(adj->edge == vertex) {
+        adj = adj->next;
+        continue;
+      }
+      link = &g->adjList[adj->edge];
+      while(*link != NULL && (*link)->edge != vertex) {
+        link = &(*link)->next;
+      }
+      if(*link != NULL) {
+        temp = *link;
+        *link = temp->next;
+        free(temp);
+      }
+      adj = adj->next;
+    }
+    return;
+  }
+
+  if(g->inAdjList != NULL) {
+    for(adj = g->inAdjList[vertex]; adj != NULL; adj = adj->next) {
+      unlinkNode(&g->adjList[adj->edge], vertex);
+    }
+    for(adj = g->adjList[vertex]; adj != NULL; adj = adj->next) {
+      unlinkNode(&g->inAdjList[adj->edge], vertex);
+    }
+    destroyAdjList(g->inAdjList[vertex]);
+    g->inAdjList[vertex] = NULL;
+    return;
+  }
+
+  for(int i = 0; i < g->size; i++) {
+    link = &g->adjList[i];
+    while(*link != NULL) {
+      if((*link)->edge == vertex) {
+        temp = *link;
+        *link = temp->next;
+        free(temp);
+      } else {
+        link = &(*link)->next;
+      }
+    }
+  }
+}
+
+void setLazyVertexRemoval(graph *g, bool lazy) {
+  g->lazyRemoval = lazy;
+}
+
 bool removeVertex(graph *g, int vertex) {
   if(!containsVertex(g, vertex)) return false;
 
-  edgenode *edges = NULL;
-  edgenode *predecessor = NULL;
-  edgenode *temp = NULL;
+  if(g->lazyRemoval) {
+    if(g->removed == NULL) {
+      g->removed = (bool *) calloc(g->size, sizeof(bool));
+    }
+    while(g->connectivity != NULL && g->adjList[vertex] != NULL) {
+      removeEdge(g, vertex, g->adjList[vertex]->edge);
+    }
+    removeIncomingEdges(g, vertex);
+    destroyAdjList(g->adjList[vertex]);
+    g->adjList[vertex] = NULL;
+    g->removed[vertex] = true;
+    g->removedCount += 1;
+
+    return true;
+  }
 
   destroyAdjList(g->adjList[vertex]);
   for(int i = vertex; i < g->size-1; i++) {
@@ -103,39 +252,77 @@ bool removeVertex(graph *g, int vertex) {
   }
   g->adjList[g->size-1] = NULL;
 
+  if(g->inAdjList != NULL) {
+    destroyAdjList(g->inAdjList[vertex]);
+    memmove(&g->inAdjList[vertex], &g->inAdjList[vertex+1], sizeof(edgenode *) * (g->size-1 - vertex));
+    g->inAdjList[g->size-1] = NULL;
+  }
+
+  if(g->removed != NULL) {
+    memmove(&g->removed[vertex], &g->removed[vertex+1], sizeof(bool) * (g->size-1 - vertex));
+  }
+
   g->size -= 1;
   g->adjList = (edgenode **) realloc(g->adjList, sizeof(edgenode *) * g->size);
 
   for(int i = 0; i < g->size; i++) {
-    edges = g->adjList[i];
-    predecessor = NULL;
-    while(edges != NULL) {
-      if(edges->edge == vertex) {
-        if(predecessor == NULL) {
-          temp = edges;
-          g->adjList[i] = edges->next;
-          edges = edges->next;
-          free(temp);
-        } else {
-          temp = edges;
-          predecessor->next = edges->next;
-          edges = edges->next;
-          free(temp);
-        }
-      } else if(edges->edge > vertex) {
-        edges->edge -= 1;
-        predecessor = edges;
-        edges = edges->next;
-      } else {
-        predecessor = edges;
-        edges = edges->next;
-      }
+    unlinkAndRenumber(&g->adjList[i], vertex);
+    if(g->inAdjList != NULL) {
+      unlinkAndRenumber(&g->inAdjList[i], vertex);
     }
   }
 
+  if(g->connectivity != NULL) {
+    connectivityRebuild(g);
+  }
+
   return true;
 }
 
+int * compactGraph(graph *g) {
+  int *newId = (int *) malloc(sizeof(int) * (g->size + 1));
+  edgenode *adj = NULL;
+  int size = 0;
+
+  for(int v = 0; v < g->size; v++) {
+    if(g->removed != NULL && g->removed[v]) {
+      newId[v] = -1;
+    } else {
+      newId[v] = size;
+      if(g->inAdjList != NULL) {
+        g->inAdjList[size] = g->inAdjList[v];
+      }
+      g->adjList[size++] = g->adjList[v];
+    }
+  }
+
+  if(size != g->size) {
+    for(int v = 0; v < size; v++) {
+      for(adj = g->adjList[v]; adj != NULL; adj = adj->next) {
+        adj->edge = newId[adj->edge];
+      }
+      for(adj = g->inAdjList != NULL ? g->inAdjList[v] : NULL; adj != NULL; adj = adj->next) {
+        adj->edge = newId[adj->edge];
+      }
+    }
+    g->size = size;
+    g->adjList = (edgenode **) realloc(g->adjList, sizeof(edgenode *) * (size + 1));
+    if(g->inAdjList != NULL) {
+      g->inAdjList = (edgenode **) realloc(g->inAdjList, sizeof(edgenode *) * (size + 1));
+    }
+  }
+
+  free(g->removed);
+  g->removed = NULL;
+  g->removedCount = 0;
+
+  if(g->connectivity != NULL) {
+    connectivityRebuild(g);
+  }
+
+  return newId;
+}
+
 bool addEdge(graph *g, int source, int destination) {
   if(!containsVertex(g, source) || !containsVertex(g, destination) || containsEdge(g, source, destination)) return false;
 
@@ -153,6 +340,16 @@ bool addEdge(graph *g, int source, int destination) {
     node->weight = DEFAULT_EDGE_WEIGHT;
     node->next = g->adjList[destination];
     g->adjList[destination] = node;
+  } else if(g->inAdjList != NULL) {
+    node = (edgenode *) malloc(sizeof(edgenode));
+    node->edge = source;
+    node->weight = DEFAULT_EDGE_WEIGHT;
+    node->next = g->inAdjList[destination];
+    g->inAdjList[destination] = node;
+  }
+
+  if(g->connectivity != NULL) {
+    connectivityAddEdge(g, source, destination);
   }
 
   return true;
@@ -165,6 +362,8 @@ bool addEdgeWeight(graph *g, int source, int destination, int weight) {
     g->adjList[source]->weight = weight;
     if(!g->directed) {
       g->adjList[destination]->weight = weight;
+    } else if(g->inAdjList != NULL) {
+      g->inAdjList[destination]->weight = weight;
     }
 
     return true;
@@ -174,6 +373,8 @@ bool addEdgeWeight(graph *g, int source, int destination, int weight) {
 }
 
 bool setEdgeWeight(graph *g, int source, int destination, int weight) {
+  if(!containsEdge(g, source, destination)) return false;
+
   edgenode *adj = g->adjList[source];
   bool find = false;
 
@@ -185,8 +386,9 @@ bool setEdgeWeight(graph *g, int source, int destination, int weight) {
     adj = adj->next;
   }
 
-  if(!g->directed) {
-    adj = g->adjList[destination];
+  if(!g->directed || g->inAdjList != NULL) {
+    adj = g->directed ? g->inAdjList[destination] : g->adjList[destination];
+    find = false;
 
     while(adj != NULL && !find) {
       if(adj->edge == source) {
@@ -277,9 +479,16 @@ bool removeEdge(graph *g, int source, int destination) {
         }
         removed = 1;
       } else {
+        predecessor = edges;
         edges = edges->next;
       }
     }
+  } else if(g->inAdjList != NULL) {
+    unlinkNode(&g->inAdjList[destination], source);
+  }
+
+  if(g->connectivity != NULL) {
+    connectivityRemoveEdge(g, source, destination);
   }
 
   return true;
@@ -306,6 +515,126 @@ edgenode * getAdjacent(graph *g, int vertex) {
   return g->adjList[vertex];
 }
 
+weightedEdge * getEdges(graph *g, int *nedges) {
+  weightedEdge *edges = (weightedEdge *) malloc(sizeof(weightedEdge) * (getNumberOfEdges(g) + 1));
+  edgenode *adj = NULL;
+  int j = 0;
+
+  for(int v = 0; v < g->size; v++) {
+    adj = g->adjList[v];
+    while(adj != NULL) {
+      if(g->directed || adj->edge > v) {
+        edges[j].source = v;
+        edges[j].destination = adj->edge;
+        edges[j].weight = adj->weight;
+        j++;
+      }
+      adj = adj->next;
+    }
+  }
+
+  *nedges = j;
+  return edges;
+}
+
+typedef struct radixSortTask radixSortTask;
+
+struct radixSortTask {
+  weightedEdge *from;
+  weightedEdge *to;
+  int nedges;
+  int nblocks;
+  int shift;
+  int (*count)[256];
+};
+
+static unsigned int radixKey(weightedEdge *e, int shift) {
+  return ((((unsigned int) e->weight) ^ 0x80000000u) >> shift) & 0xFF;
+}
+
+static void radixCountChunk(int start, int end, void *arg) {
+  radixSortTask *task = (radixSortTask *) arg;
+
+  for(int b = start; b < end; b++) {
+    int first = (int) ((long) task->nedges * b / task->nblocks);
+    int last = (int) ((long) task->nedges * (b+1) / task->nblocks);
+
+    memset(task->count[b], 0, sizeof(task->count[b]));
+    for(int i = first; i < last; i++) {
+      task->count[b][radixKey(&task->from[i], task->shift)] += 1;
+    }
+  }
+}
+
+static void radixScatterChunk(int start, int end, void *arg) {
+  radixSortTask *task = (radixSortTask *) arg;
+
+  for(int b = start; b < end; b++) {
+    int first = (int) ((long) task->nedges * b / task->nblocks);
+    int last = (int) ((long) task->nedges * (b+1) / task->nblocks);
+
+    for(int i = first; i < last; i++) {
+      task->to[task->count[b][radixKey(&task->from[i], task->shift)]++] = task->from[i];
+    }
+  }
+}
+
+/**
+ * Least significant digit radix sort, one byte per pass. Each block counts its digits,
+ * then the counts are turned into the scatter offsets of the blocks (block order keeps the sort stable).
+ * The passes where all the edges have the same digit are skipped.
+ */
+void sortEdgesByWeight(weightedEdge *edges, int nedges) {
+  if(nedges <= 1) return;
+
+  radixSortTask task;
+  weightedEdge *buffer = (weightedEdge *) malloc(sizeof(weightedEdge) * nedges);
+  int offset;
+  int total;
+  bool skip;
+
+  task.nedges = nedges;
+  task.nblocks = getNumberOfThreads();
+  if(task.nblocks > nedges) task.nblocks = nedges;
+  task.count = (int (*)[256]) malloc(sizeof(int[256]) * task.nblocks);
+  task.from = edges;
+  task.to = buffer;
+
+  for(task.shift = 0; task.shift < 32; task.shift += 8) {
+    parallelFor(0, task.nblocks, radixCountChunk, &task);
+
+    skip = false;
+    offset = 0;
+    for(int d = 0; d < 256; d++) {
+      total = 0;
+      for(int b = 0; b < task.nblocks; b++) {
+        total += task.count[b][d];
+      }
+      if(total == nedges) {
+        skip = true;
+        break;
+      }
+      for(int b = 0; b < task.nblocks; b++) {
+        total = task.count[b][d];
+        task.count[b][d] = offset;
+        offset += total;
+      }
+    }
+    if(skip) continue;
+
+    parallelFor(0, task.nblocks, radixScatterChunk, &task);
+    task.to = task.from;
+    task.from = task.from == edges ? buffer : edges;
+  }
+
+  if(task.from != edges) {
+    memcpy(edges, task.from, sizeof(weightedEdge) * nedges);
+  }
+
+  free(task.count);
+  free(buffer);
+}
+
 bool isCyclic(graph *g) {
   visitInfo *visit = initializeVisit(g);
   for(int i = 0; i < g->size; i++) {
@@ -345,12 +674,18 @@ bool isCyclicImpl(graph *g, int vertex, visitInfo *visit) {
 
 bool isConnected(graph *g) {
   if(g->directed) return false;
+  if(g->connectivity != NULL) return getNumberOfComponents(g) == 1;
 
   visitInfo *visit = NULL;
-  
-  visit = getDFS(g, 0);
+  int start = 0;
+
+  // The tombstones are not part of the graph: the visit starts from the first vertex that exists
+  while(start < g->size - 1 && !containsVertex(g, start)) {
+    start++;
+  }
+  visit = getDFS(g, start);
   for(int i = 0; i < g->size; i++) {
-    if(visit->color[i] != BLACK) {
+    if(containsVertex(g, i) && visit->color[i] != BLACK) {
       destroyVisit(visit);
       return false;
     }
@@ -367,7 +702,7 @@ bool isStronglyConnected(graph *g) {
 
   if(stronglyConnectedComponents != NULL) {
     for(int i = 0; i < g->size; i++) {
-      if(containsNode(stronglyConnectedComponents, i, 0) == false) {
+      if(containsVertex(g, i) && containsNode(stronglyConnectedComponents, i, 0) == false) {
         destroyLists(stronglyConnectedComponents);
         return false;
       }
@@ -382,6 +717,29 @@ bool isStronglyConnected(graph *g) {
 
 lists * getConnectedComponents(graph *g) {
   if(g->directed) return NULL;
+
+  if(g->connectivity != NULL) {
+    lists *connectedComponents = initializeLists();
+    int *index = (int *) malloc(sizeof(int) * (g->connectivity->nids + 1));
+    int id;
+
+    for(int i = 0; i < g->connectivity->nids; i++) {
+      index[i] = -1;
+    }
+    for(int v = 0; v < g->size; v++) {
+      if(g->removed != NULL && g->removed[v]) continue;
+
+      id = k_find(g->connectivity->ids, g->connectivity->component[v]);
+      if(index[id] == -1) {
+        index[id] = connectedComponents->size;
+        addList(connectedComponents, NULL);
+      }
+      addNode(connectedComponents, v, index[id]);
+    }
+
+    free(index);
+    return connectedComponents;
+  }
   
   int order[g->size];
   for(int i = 0; i < g->size; i++) {
@@ -391,6 +749,100 @@ lists * getConnectedComponents(graph *g) {
   return computeComponents(g, order);
 }
 
+typedef struct componentsTask componentsTask;
+
+struct componentsTask {
+  graph *g;
+  c_union_find *cunion;
+  int skip;
+};
+
+static void linkFirstNeighbourChunk(int start, int end, void *arg) {
+  componentsTask *task = (componentsTask *) arg;
+
+  for(int v = start; v < end; v++) {
+    if(task->g->adjList[v] != NULL) {
+      c_union(task->cunion, v, task->g->adjList[v]->edge);
+    }
+  }
+}
+
+static void compressChunk(int start, int end, void *arg) {
+  componentsTask *task = (componentsTask *) arg;
+
+  for(int v = start; v < end; v++) {
+    atomic_store_explicit(&task->cunion->parent[v], c_find(task->cunion, v), memory_order_relaxed);
+  }
+}
+
+static void linkRemainingChunk(int start, int end, void *arg) {
+  componentsTask *task = (componentsTask *) arg;
+  edgenode *adj = NULL;
+
+  for(int v = start; v < end; v++) {
+    if(c_find(task->cunion, v) == task->skip) continue;
+
+    adj = task->g->adjList[v];
+    while(adj != NULL) {
+      c_union(task->cunion, v, adj->edge);
+      adj = adj->next;
+    }
+  }
+}
+
+/**
+ * It is used the Afforest algorithm:
+ *
+ * 1. link every vertex to its first neighbour, so most of the vertices fall in few big trees
+ * 2. sample some vertices to guess the biggest component
+ * 3. link all the edges of the vertices outside the biggest component (an edge between two vertices
+ *    of the biggest component can be skipped, an edge leaving it is seen from the other endpoint)
+ */
+lists * getParallelConnectedComponents(graph *g) {
+  if(g->directed) return NULL;
+
+  lists *connectedComponents = initializeLists();
+  c_union_find *cunion = initializeCUnionFind(g->size);
+  componentsTask task = {g, cunion, -1};
+  int *count = (int *) calloc(g->size, sizeof(int));
+  int step = g->size / 1024 + 1;
+  int root;
+
+  parallelFor(0, g->size, linkFirstNeighbourChunk, &task);
+  parallelFor(0, g->size, compressChunk, &task);
+
+  for(int v = 0; v < g->size; v += step) {
+    if(!containsVertex(g, v)) continue;
+
+    root = c_find(cunion, v);
+    count[root] += 1;
+    if(task.skip == -1 || count[root] > count[task.skip]) {
+      task.skip = root;
+    }
+  }
+
+  parallelFor(0, g->size, linkRemainingChunk, &task);
+
+  /* count is reused as the index of the component of each root */
+  for(int v = 0; v < g->size; v++) {
+    count[v] = -1;
+  }
+  for(int v = 0; v < g->size; v++) {
+    if(!containsVertex(g, v)) continue;
+
+    root = c_find(cunion, v);
+    if(count[root] == -1) {
+      count[root] = connectedComponents->size;
+      addList(connectedComponents, NULL);
+    }
+    addNode(connectedComponents, v, count[root]);
+  }
+
+  free(count);
+  destroyCUnionFind(cunion);
+  return connectedComponents;
+}
+
 /**
  * It is used the Kosaraju algorithm to calculate the strongly connected components:
  *
@@ -403,10 +855,18 @@ lists * getStronglyConnectedComponents(graph *g) {
 
   graph *gTranspose = NULL;
   lists *stronglyConnectedComponents = NULL;
-  visitInfo *visit = getDFSTOTForest(g, 0);;
+  visitInfo *visit = NULL;
+  int start = 0;
   int order_endtime[g->size][2];
   int order[g->size];
 
+  // The tombstones are not visited: the forest starts from the first vertex that exists
+  while(start < g->size - 1 && !containsVertex(g, start)) {
+    start++;
+  }
+  visit = getDFSTOTForest(g, start);
+  if(visit == NULL) return initializeLists();
+
   for(int i = 0; i < g->size; i++) {
     order_endtime[i][0] = i;
     order_endtime[i][1] = visit->endTime[i];
@@ -428,15 +888,34 @@ lists * getStronglyConnectedComponents(graph *g) {
 graph * getTransposedGraph(graph *g) {
   graph *gTranspose = initializeGraph(true);
   edgenode *adj = NULL;
-  addVertex(gTranspose, g->size);
+  edgenode *node = NULL;
+
+  if(g->directed && g->inAdjList != NULL) {
+    gTranspose->adjList = g->inAdjList;
+    gTranspose->inAdjList = g->adjList;
+    gTranspose->size = g->size;
+    gTranspose->removed = g->removed;
+    gTranspose->removedCount = g->removedCount;
+    gTranspose->view = true;
+    return gTranspose;
+  }
 
+  addVertex(gTranspose, g->size);
   for(int i = 0; i < g->size; i++) {
-    adj = g->adjList[i];
-    while(adj != NULL) {
-      addEdge(gTranspose, adj->edge, i);
-      adj = adj->next;
+    for(adj = g->adjList[i]; adj != NULL; adj = adj->next) {
+      node = (edgenode *) malloc(sizeof(edgenode));
+      node->edge = i;
+      node->weight = adj->weight;
+      node->next = gTranspose->adjList[adj->edge];
+      gTranspose->adjList[adj->edge] = node;
     }
   }
+  if(g->removed != NULL) {
+    gTranspose->lazyRemoval = g->lazyRemoval;
+    gTranspose->removed = (bool *) malloc(sizeof(bool) * g->size);
+    memcpy(gTranspose->removed, g->removed, sizeof(bool) * g->size);
+    gTranspose->removedCount = g->removedCount;
+  }
   
   return gTranspose;
 }
@@ -455,7 +934,7 @@ lists * computeComponents(graph *g, int *order) {
   }
 
   for(int i = 0; i < g->size; i++) {
-    if(visit->color[order[i]] == WHITE) {
+    if(containsVertex(g, order[i]) && visit->color[order[i]] == WHITE) {
       getDFSImpl(g, order[i], &time, visit);
       component = NULL;
 
@@ -503,50 +982,525 @@ int * getTopologicalSort(graph *g) {
   return order;
 }
 
-/* BASIC GRAPH OPERATIONS - END */
-
-
-/* GRAPH TRAVERSAL - START */
-
-visitInfo * getBFS(graph *g, int startingVertex) {
-  if(!containsVertex(g, startingVertex)) return NULL;
+/**
+ * The order array is also used as the queue of the vertices with no incoming edges:
+ * the vertices between levelStart and levelEnd form the current level.
+ */
+int * getKahnTopologicalSort(graph *g, lists **levels) {
+  if(levels != NULL) *levels = NULL;
+  if(!g->directed) return NULL;
 
-  visitInfo *visit = initializeVisit(g);
-  queue *q = initializeQueue();
+  int *order = (int *) malloc(sizeof(int) * g->size);
+  int *inDegree = (int *) calloc(g->size, sizeof(int));
   edgenode *adj = NULL;
-  int vertex;
-  int time = 0;
+  lists *l = levels != NULL ? initializeLists() : NULL;
+  int levelStart = 0;
+  int levelEnd = 0;
+  int tail = 0;
 
-  visit->distance[startingVertex] = 0;
-  visit->color[startingVertex] = GRAY;
-  enqueue(q, startingVertex);
-  while(q->size != 0) {
-    vertex = dequeue(q);
-    visit->startTime[vertex] = time++;
-    adj = getAdjacent(g, vertex);
+  for(int v = 0; v < g->size; v++) {
+    adj = g->adjList[v];
     while(adj != NULL) {
-      if(visit->color[adj->edge] == WHITE) {
-        visit->color[adj->edge] = GRAY;
-        visit->parent[adj->edge] = vertex;
-        enqueue(q, adj->edge);
-      }
+      inDegree[adj->edge] += 1;
       adj = adj->next;
     }
-    visit->color[vertex] = BLACK;
-    visit->endTime[vertex] = time++;
   }
-  destroyQueue(q);
 
-  return visit;
+  for(int v = 0; v < g->size; v++) {
+    if(inDegree[v] == 0) {
+      order[tail++] = v;
+    }
+  }
+
+  while(levelStart < tail) {
+    levelEnd = tail;
+    if(l != NULL) {
+      addList(l, NULL);
+    }
+
+    for(int i = levelStart; i < levelEnd; i++) {
+      if(l != NULL) {
+        addNode(l, order[i], l->size-1);
+      }
+      adj = g->adjList[order[i]];
+      while(adj != NULL) {
+        inDegree[adj->edge] -= 1;
+        if(inDegree[adj->edge] == 0) {
+          order[tail++] = adj->edge;
+        }
+        adj = adj->next;
+      }
+    }
+    levelStart = levelEnd;
+  }
+
+  free(inDegree);
+
+  if(tail != g->size) {
+    free(order);
+    if(l != NULL) {
+      destroyLists(l);
+    }
+    return NULL;
+  }
+
+  if(levels != NULL) *levels = l;
+  return order;
 }
 
-visitInfo * getDFS(graph *g, int startingVertex) {
-  if(!containsVertex(g, startingVertex)) return NULL;
+/* BASIC GRAPH OPERATIONS - END */
 
-  visitInfo *visit = initializeVisit(g);
-  int time = 0;
-  
-  return getDFSImpl(g, startingVertex, &time, visit);
+
+/* REVERSE INDEX - START */
+
+bool enableReverseIndex(graph *g) {
+  if(!g->directed) return false;
+  if(g->inAdjList != NULL) return true;
+
+  edgenode *node = NULL;
+
+  g->inAdjList = (edgenode **) calloc(g->size + 1, sizeof(edgenode *));
+  for(int v = 0; v < g->size; v++) {
+    for(edgenode *adj = g->adjList[v]; adj != NULL; adj = adj->next) {
+      node = (edgenode *) malloc(sizeof(edgenode));
+      node->edge = v;
+      node->weight = adj->weight;
+      node->next = g->inAdjList[adj->edge];
+      g->inAdjList[adj->edge] = node;
+    }
+  }
+
+  return true;
+}
+
+void disableReverseIndex(graph *g) {
+  if(g->inAdjList == NULL) return;
+
+  for(int v = 0; v < g->size; v++) {
+    destroyAdjList(g->inAdjList[v]);
+  }
+  free(g->inAdjList);
+  g->inAdjList = NULL;
+}
+
+edgenode * getIncomingEdges(graph *g, int vertex) {
+  if(!containsVertex(g, vertex)) return NULL;
+
+  if(!g->directed) return g->adjList[vertex];
+  return g->inAdjList != NULL ? g->inAdjList[vertex] : NULL;
+}
+
+/* REVERSE INDEX - END */
+
+
+/* DYNAMIC CONNECTIVITY - START */
+
+bool enableDynamicConnectivity(graph *g) {
+  if(g->directed) return false;
+  if(g->connectivity != NULL) return true;
+
+  g->connectivity = (connectivity *) malloc(sizeof(connectivity));
+  g->connectivity->component = (int *) malloc(sizeof(int) * (g->size + 1));
+  g->connectivity->mark = (int *) calloc(g->size + 1, sizeof(int));
+  g->connectivity->queue = (int *) malloc(sizeof(int) * (2 * g->size + 1));
+  g->connectivity->ids = NULL;
+  connectivityRebuild(g);
+
+  return true;
+}
+
+void disableDynamicConnectivity(graph *g) {
+  if(g->connectivity == NULL) return;
+
+  free(g->connectivity->component);
+  free(g->connectivity->mark);
+  free(g->connectivity->queue);
+  destroyKUnionFind(g->connectivity->ids);
+  free(g->connectivity);
+  g->connectivity = NULL;
+}
+
+int getNumberOfComponents(graph *g) {
+  if(g->directed) return -1;
+  if(g->connectivity != NULL) return g->connectivity->count - g->removedCount;
+
+  lists *connectedComponents = getParallelConnectedComponents(g);
+  int count = connectedComponents->size;
+
+  destroyLists(connectedComponents);
+  return count;
+}
+
+bool sameComponent(graph *g, int a, int b) {
+  if(g->directed || !containsVertex(g, a) || !containsVertex(g, b)) return false;
+
+  if(g->connectivity != NULL) {
+    return k_find(g->connectivity->ids, g->connectivity->component[a]) == k_find(g->connectivity->ids, g->connectivity->component[b]);
+  }
+
+  visitInfo *visit = getBFS(g, a);
+  bool same = visit->color[b] == BLACK;
+
+  destroyVisit(visit);
+  return same;
+}
+
+/**
+ * The components are labelled with a BFS: the union find is sized so that about size splits can happen
+ * before it has to be computed again.
+ */
+void connectivityRebuild(graph *g) {
+  connectivity *c = g->connectivity;
+  edgenode *adj = NULL;
+  int head;
+  int tail;
+
+  if(c->ids != NULL) {
+    destroyKUnionFind(c->ids);
+  }
+  c->ids = initializeKUnionFind(2 * g->size + 16);
+  c->nids = 0;
+
+  for(int v = 0; v < g->size; v++) {
+    c->component[v] = -1;
+  }
+  for(int v = 0; v < g->size; v++) {
+    if(c->component[v] != -1) continue;
+
+    c->component[v] = c->nids;
+    c->queue[0] = v;
+    head = 0;
+    tail = 1;
+    while(head < tail) {
+      adj = g->adjList[c->queue[head++]];
+      while(adj != NULL) {
+        if(c->component[adj->edge] == -1) {
+          c->component[adj->edge] = c->nids;
+          c->queue[tail++] = adj->edge;
+        }
+        adj = adj->next;
+      }
+    }
+    c->nids += 1;
+  }
+
+  c->count = c->nids;
+}
+
+void connectivityAddVertices(graph *g, int n) {
+  connectivity *c = g->connectivity;
+
+  c->component = (int *) realloc(c->component, sizeof(int) * (g->size + 1));
+  c->mark = (int *) realloc(c->mark, sizeof(int) * (g->size + 1));
+  c->queue = (int *) realloc(c->queue, sizeof(int) * (2 * g->size + 1));
+  for(int v = g->size - n; v < g->size; v++) {
+    c->mark[v] = 0;
+  }
+
+  if(c->nids + n > c->ids->size) {
+    connectivityRebuild(g);
+    return;
+  }
+
+  for(int v = g->size - n; v < g->size; v++) {
+    c->component[v] = c->nids++;
+  }
+  c->count += n;
+}
+
+void connectivityAddEdge(graph *g, int a, int b) {
+  connectivity *c = g->connectivity;
+  int x = k_find(c->ids, c->component[a]);
+  int y = k_find(c->ids, c->component[b]);
+
+  if(x != y) {
+    k_union(c->ids, x, y);
+    c->count -= 1;
+  }
+}
+
+void connectivityRemoveEdge(graph *g, int a, int b) {
+  connectivity *c = g->connectivity;
+  int *queueA = c->queue;
+  int *queueB = c->queue + g->size;
+  int headA = 0;
+  int headB = 0;
+  int tailA = 1;
+  int tailB = 1;
+  bool connected = false;
+  edgenode *adj = NULL;
+
+  if(a == b) return;
+
+  queueA[0] = a;
+  queueB[0] = b;
+  c->mark[a] = 1;
+  c->mark[b] = 2;
+
+  while(!connected && headA < tailA && headB < tailB) {
+    for(adj = g->adjList[queueA[headA++]]; adj != NULL && !connected; adj = adj->next) {
+      if(c->mark[adj->edge] == 2) {
+        connected = true;
+      } else if(c->mark[adj->edge] == 0) {
+        c->mark[adj->edge] = 1;
+        queueA[tailA++] = adj->edge;
+      }
+    }
+    for(adj = g->adjList[queueB[headB++]]; adj != NULL && !connected; adj = adj->next) {
+      if(c->mark[adj->edge] == 1) {
+        connected = true;
+      } else if(c->mark[adj->edge] == 0) {
+        c->mark[adj->edge] = 2;
+        queueB[tailB++] = adj->edge;
+      }
+    }
+  }
+
+  for(int i = 0; i < tailA; i++) {
+    c->mark[queueA[i]] = 0;
+  }
+  for(int i = 0; i < tailB; i++) {
+    c->mark[queueB[i]] = 0;
+  }
+
+  if(connected) return;
+
+  if(c->nids == c->ids->size) {
+    connectivityRebuild(g);
+    return;
+  }
+
+  if(headA == tailA) {
+    for(int i = 0; i < tailA; i++) {
+      c->component[queueA[i]] = c->nids;
+    }
+  } else {
+    for(int i = 0; i < tailB; i++) {
+      c->component[queueB[i]] = c->nids;
+    }
+  }
+  c->nids += 1;
+  c->count += 1;
+}
+
+/* DYNAMIC CONNECTIVITY - END */
+
+
+/* BATCH OPERATIONS - START */
+
+typedef struct mutationTask mutationTask;
+
+/**
+ * A half is a mutation seen from one endpoint: half 2*i is mutation i from its source,
+ * half 2*i+1 is mutation i from its destination (only for undirected graphs and for directed graphs with the
+ * reverse index, where it changes the incoming list of the destination).
+ * The lists are the adjacency lists followed by the incoming lists (see mutationList), and the halves of list l
+ * are halves[offset[l]] ... halves[offset[l+1]-1].
+ */
+struct mutationTask {
+  graph *g;
+  edgeMutation *mutations;
+  int *halves;
+  int *offset;
+};
+
+static edgenode ** mutationList(graph *g, int list) {
+  return list < g->size ? &g->adjList[list] : &g->inAdjList[list - g->size];
+}
+
+static void applyMutationsChunk(int start, int end, void *arg) {
+  mutationTask *task = (mutationTask *) arg;
+  edgeMutation *m = NULL;
+  edgenode **found = NULL;
+  edgenode **list = NULL;
+  edgenode **link = NULL;
+  edgenode *adj = NULL;
+  edgenode *node = NULL;
+  int destination;
+  int h;
+
+  if(task->offset[start] == task->offset[end]) return;
+  found = (edgenode **) calloc(task->g->size, sizeof(edgenode *));
+
+  for(int v = start; v < end; v++) {
+    if(task->offset[v] == task->offset[v+1]) continue;
+
+    list = mutationList(task->g, v);
+    adj = *list;
+    while(adj != NULL) {
+      found[adj->edge] = adj;
+      adj = adj->next;
+    }
+
+    for(int i = task->offset[v]; i < task->offset[v+1]; i++) {
+      h = task->halves[i];
+      m = &task->mutations[h/2];
+      destination = h % 2 == 0 ? m->destination : m->source;
+
+      if(m->type == INSERT_EDGE && found[destination] == NULL) {
+        node = (edgenode *) malloc(sizeof(edgenode));
+        node->edge = destination;
+        node->weight = m->weight;
+        node->next = *list;
+        *list = node;
+        found[destination] = node;
+      } else if(m->type == DELETE_EDGE && found[destination] != NULL) {
+        found[destination]->edge = -1;
+        found[destination] = NULL;
+      } else if(m->type == SET_EDGE_WEIGHT && found[destination] != NULL) {
+        found[destination]->weight = m->weight;
+      } else {
+        continue;
+      }
+
+      if(h % 2 == 0) {
+        m->applied = true;
+      }
+    }
+
+    link = list;
+    while(*link != NULL) {
+      if((*link)->edge == -1) {
+        node = *link;
+        *link = node->next;
+        free(node);
+      } else {
+        found[(*link)->edge] = NULL;
+        link = &(*link)->next;
+      }
+    }
+  }
+
+  free(found);
+}
+
+static bool validMutation(graph *g, edgeMutation *m) {
+  return containsVertex(g, m->source) && containsVertex(g, m->destination) && (g->directed || m->source != m->destination);
+}
+
+/**
+ * The halves are grouped by vertex with a counting sort, which keeps the order of the mutations of the same vertex.
+ */
+int applyEdgeMutations(graph *g, edgeMutation *mutations, int nmutations, bool parallel) {
+  mutationTask task;
+  bool mirrored = !g->directed || g->inAdjList != NULL;
+  int nlists = g->directed && mirrored ? 2 * g->size : g->size;
+  int mirror = g->directed ? g->size : 0;
+  int *position = (int *) calloc(nlists + 1, sizeof(int));
+  int applied = 0;
+  int total = 0;
+
+  task.g = g;
+  task.mutations = mutations;
+  task.halves = (int *) malloc(sizeof(int) * (2 * nmutations + 1));
+  task.offset = (int *) calloc(nlists + 1, sizeof(int));
+
+  for(int i = 0; i < nmutations; i++) {
+    mutations[i].applied = false;
+    if(!validMutation(g, &mutations[i])) continue;
+
+    task.offset[mutations[i].source] += 1;
+    if(mirrored) {
+      task.offset[mirror + mutations[i].destination] += 1;
+    }
+  }
+  for(int l = 0; l < nlists; l++) {
+    position[l] = total;
+    total += task.offset[l];
+    task.offset[l] = position[l];
+  }
+  task.offset[nlists] = total;
+  for(int i = 0; i < nmutations; i++) {
+    if(!validMutation(g, &mutations[i])) continue;
+
+    task.halves[position[mutations[i].source]++] = 2*i;
+    if(mirrored) {
+      task.halves[position[mirror + mutations[i].destination]++] = 2*i + 1;
+    }
+  }
+
+  if(parallel) {
+    /* one chunk per thread: each chunk allocates its own found array */
+    parallelForGrain(0, nlists, nlists / getNumberOfThreads() + 1, applyMutationsChunk, &task);
+  } else if(nlists > 0) {
+    applyMutationsChunk(0, nlists, &task);
+  }
+
+  for(int i = 0; i < nmutations; i++) {
+    if(mutations[i].applied) {
+      applied += 1;
+    }
+  }
+
+  if(g->connectivity != NULL) {
+    connectivityRebuild(g);
+  }
+
+  free(position);
+  free(task.halves);
+  free(task.offset);
+  return applied;
+}
+
+int removeVertices(graph *g, int *vertices, int n) {
+  edgenode **link = NULL;
+  edgenode *temp = NULL;
+  int nlists = g->inAdjList != NULL ? 2 * g->size : g->size;
+  int removed = 0;
+  int *newId = NULL;
+
+  if(g->removed == NULL) {
+    g->removed = (bool *) calloc(g->size + 1, sizeof(bool));
+  }
+
+  for(int i = 0; i < n; i++) {
+    if(containsVertex(g, vertices[i])) {
+      g->removed[vertices[i]] = true;
+      destroyAdjList(g->adjList[vertices[i]]);
+      g->adjList[vertices[i]] = NULL;
+      if(g->inAdjList != NULL) {
+        destroyAdjList(g->inAdjList[vertices[i]]);
+        g->inAdjList[vertices[i]] = NULL;
+      }
+      removed += 1;
+    }
+  }
+  g->removedCount += removed;
+
+  for(int l = 0; l < nlists; l++) {
+    link = mutationList(g, l);
+    while(*link != NULL) {
+      if(g->removed[(*link)->edge]) {
+        temp = *link;
+        *link = temp->next;
+        free(temp);
+      } else {
+        link = &(*link)->next;
+      }
+    }
+  }
+
+  if(!g->lazyRemoval) {
+    newId = compactGraph(g);
+    free(newId);
+  } else if(g->connectivity != NULL) {
+    connectivityRebuild(g);
+  }
+
+  return removed;
+}
+
+/* BATCH OPERATIONS - END */
+
+
+/* GRAPH TRAVERSAL - START */
+
+visitInfo * getBFS(graph *g, int startingVertex) {
+  return getListBFS(g, startingVertex);
+}
+
+visitInfo * getDFS(graph *g, int startingVertex) {
+  return getListDFS(g, startingVertex);
 }
 
 visitInfo * getDFSImpl(graph *g, int vertex, int *time, visitInfo *visit) {
@@ -555,6 +1509,7 @@ visitInfo * getDFSImpl(graph *g, int vertex, int *time, visitInfo *visit) {
   
   edgenode *adj = getAdjacent(g, vertex);
   while(adj != NULL) {
+    STATS_ADD(edgesScanned, 1);
     if(visit->color[adj->edge] == WHITE) {
       visit->parent[adj->edge] = vertex;
       getDFSImpl(g, adj->edge, time, visit);
@@ -562,6 +1517,7 @@ visitInfo * getDFSImpl(graph *g, int vertex, int *time, visitInfo *visit) {
     adj = adj->next;
   }
 
+  STATS_ADD(verticesSettled, 1);
   visit->color[vertex] = BLACK;
   visit->endTime[vertex] = (*time)++;
   return visit;
@@ -575,7 +1531,7 @@ visitInfo * getDFSTOTForest(graph *g, int startingVertex) {
 
   visit = getDFSImpl(g, startingVertex, &time, visit);
   for(int i = 0; i < g->size; i++) {
-    if(visit->color[i] == WHITE)
+    if(containsVertex(g, i) && visit->color[i] == WHITE)
       visit = getDFSImpl(g, i, &time, visit);
   }
   
@@ -590,6 +1546,7 @@ visitInfo * getDFSTOTForest(graph *g, int startingVertex) {
 visitInfo * getDijkstraShortestPaths(graph *g, int startingVertex) {
   if(!containsVertex(g, startingVertex)) return NULL;
   
+  STATS_PHASE_START(STATS_INITIALIZATION);
   visitInfo *visit = initializeVisit(g);
   queue *q = initializeQueue();
   edgenode *adj = NULL;
@@ -599,16 +1556,22 @@ visitInfo * getDijkstraShortestPaths(graph *g, int startingVertex) {
   for(int v = 0; v < g->size; v++) {
     enqueuePriority(q, v, visit->distance[v]);
   }
+  STATS_PHASE_END(STATS_INITIALIZATION);
 
+  STATS_PHASE_START(STATS_SEARCH);
   while(q->size > 0) {
     vertex = dequeuePriority(q);
+    STATS_ADD(verticesSettled, 1);
     adj = getAdjacent(g, vertex);
     while(adj != NULL) {
+      STATS_ADD(edgesScanned, 1);
       if(adj->weight < 0) {
+        STATS_PHASE_END(STATS_SEARCH);
         return NULL;
       }
 
       if(visit->distance[adj->edge] > visit->distance[vertex] + adj->weight) {
+        STATS_ADD(relaxations, 1);
         visit->parent[adj->edge] = vertex;
         visit->distance[adj->edge] = visit->distance[vertex] + adj->weight;
         editPriority(q, adj->edge, visit->distance[adj->edge]);
@@ -617,6 +1580,7 @@ visitInfo * getDijkstraShortestPaths(graph *g, int startingVertex) {
     }
   }
   destroyQueue(q);
+  STATS_PHASE_END(STATS_SEARCH);
 
   return visit;
 }
@@ -644,8 +1608,10 @@ visitInfo * getBellmanFordShortestPaths(graph *g, int startingVertex) {
   visit->distance[startingVertex] = 0;
 
   for(int i = 0; i < g->size - 1; i++) {
+    STATS_ADD(edgesScanned, nedges);
     for(j = 0; j < nedges; j++) {
       if(visit->distance[edges[j][1]] > visit->distance[edges[j][0]] + edges[j][2]) {
+        STATS_ADD(relaxations, 1);
         visit->parent[edges[j][1]] = edges[j][0];
         visit->distance[edges[j][1]] = visit->distance[edges[j][0]] + edges[j][2];
       }
@@ -705,94 +1671,3065 @@ int ** getFloydWarshallShortestsPaths(graph *g) {
 /* SHORTEST PATH - END */
 
 
-/* MINUMUM SPANNING TREE - START */
-
-graph * getPrimMST(graph *g) {
-  if(!isConnected(g)) return NULL;
+/* DYNAMIC SHORTEST PATH - START */
 
-  graph *mst = initializeGraph(false);
-  visitInfo *visit = initializeVisit(g);
-  queue *q = initializeQueue();
+/**
+ * Dijkstra from the vertices already in the heap. Only the vertices whose distance decreases are pushed,
+ * so the work is limited to the part of the tree that changes.
+ */
+static void dynamicPropagate(dynamicSSSP *d, heap *h) {
+  visitInfo *visit = d->visit;
   edgenode *adj = NULL;
   int vertex;
+  int distance;
 
-  addVertex(mst, g->size);
-
-  visit->distance[0] = 0;
-  for(int v = 0; v < g->size; v++) {
-    enqueuePriority(q, v, visit->distance[v]);
-  }
+  while(h->size > 0) {
+    vertex = heapPop(h, &distance);
+    if(distance != visit->distance[vertex]) continue;
 
-  while(q->size > 0) {
-    vertex = dequeuePriority(q);
-    if(visit->parent[vertex] != -1) {
-      addEdgeWeight(mst, visit->parent[vertex], vertex, getEdgeWeight(g, visit->parent[vertex], vertex));
-    }
-    visit->color[vertex] = BLACK;
-    adj = getAdjacent(g, vertex);
+    STATS_ADD(verticesSettled, 1);
+    adj = d->g->adjList[vertex];
     while(adj != NULL) {
-      if(visit->color[adj->edge] != BLACK && visit->distance[adj->edge] > adj->weight) {
+      STATS_ADD(edgesScanned, 1);
+      if(visit->distance[adj->edge] > distance + adj->weight) {
+        STATS_ADD(relaxations, 1);
+        visit->distance[adj->edge] = distance + adj->weight;
         visit->parent[adj->edge] = vertex;
-        visit->distance[adj->edge] = adj->weight;
-        editPriority(q, adj->edge, visit->distance[adj->edge]);
+        heapPush(h, adj->edge, visit->distance[adj->edge]);
       }
       adj = adj->next;
     }
   }
-  destroyQueue(q);
-  destroyVisit(visit);
-
-  return mst;
 }
 
-graph * getKruskalMST(graph *g) {
-  if(!isConnected(g)) return NULL;
+dynamicSSSP * initializeDynamicSSSP(graph *g, int source) {
+  if(!containsVertex(g, source)) return NULL;
 
-  graph *mst = initializeGraph(false);
-  k_union_find *kunion = initializeKUnionFind(g->size);
+  dynamicSSSP *d = NULL;
+  heap *h = NULL;
   edgenode *adj = NULL;
-  int nedges = getNumberOfEdges(g);
-  int edges[nedges][3];
-  int count = 0;
-  int j = 0;
-  
+
   for(int v = 0; v < g->size; v++) {
-    adj = g->adjList[v];
-    while(adj != NULL) {
-      if(adj->edge > v) {
-        edges[j][0] = v;
-        edges[j][1] = adj->edge;
-        edges[j][2] = adj->weight;
-        j++;
-      }
-      adj = adj->next;
+    for(adj = g->adjList[v]; adj != NULL; adj = adj->next) {
+      if(adj->weight < 0) return NULL;
     }
   }
-  qsort(edges, nedges, sizeof(edges[0]), compareFunUtil2);
-
-  addVertex(mst, g->size);
 
-  for(int i = 0; i < nedges; i++) {
-    if(count == g->size-1) {
-      destroyKUnionFind(kunion);
-      return mst;
-    }
-    
-    if(k_find(kunion, edges[i][0]) != k_find(kunion, edges[i][1])) {
-      k_union(kunion, edges[i][0], edges[i][1]);
-      addEdgeWeight(mst, edges[i][0], edges[i][1], edges[i][2]);
-      count += 1;
-    }
+  d = (dynamicSSSP *) malloc(sizeof(dynamicSSSP));
+  d->g = g;
+  d->source = source;
+  d->visit = initializeVisit(g);
+  d->size = g->size;
+  d->ownsReverseIndex = g->directed && g->inAdjList == NULL;
+  if(d->ownsReverseIndex) {
+    enableReverseIndex(g);
   }
 
-  destroyKUnionFind(kunion);
-  return mst;
-}
+  h = initializeHeap(g->size);
+  d->visit->distance[source] = 0;
+  heapPush(h, source, 0);
+  dynamicPropagate(d, h);
+  destroyHeap(h);
 
-/* MINUMUM SPANNING TREE - END */
+  return d;
+}
 
+/**
+ * The visit information follows the vertices added to the graph after the initialization: the new vertices
+ * have no edges yet, so they are unreachable.
+ */
+static void dynamicGrow(dynamicSSSP *d) {
+  visitInfo *visit = d->visit;
+  int size = d->g->size;
+
+  if(size <= d->size) return;
+
+  visit->startTime = (int *) realloc(visit->startTime, sizeof(int) * size);
+  visit->endTime = (int *) realloc(visit->endTime, sizeof(int) * size);
+  visit->parent = (int *) realloc(visit->parent, sizeof(int) * size);
+  visit->distance = (int *) realloc(visit->distance, sizeof(int) * size);
+  visit->color = (enum color *) realloc(visit->color, sizeof(enum color) * size);
+  STATS_ALLOC((sizeof(int) * 4 + sizeof(enum color)) * (size - d->size));
+  for(int i = d->size; i < size; i++) {
+    visit->startTime[i] = -1;
+    visit->endTime[i] = -1;
+    visit->parent[i] = -1;
+    visit->distance[i] = MAX_DISTANCE;
+    visit->color[i] = WHITE;
+  }
+  d->size = size;
+}
 
-/* DEALLOCATING - START */
+/**
+ * The edge (source, destination) has become lighter (or it is new): if it gives a shorter path to destination,
+ * the improvement is propagated from there.
+ */
+static void dynamicDecrease(dynamicSSSP *d, int source, int destination, int weight) {
+  visitInfo *visit = d->visit;
+  heap *h = NULL;
+
+  if(visit->distance[source] == MAX_DISTANCE || visit->distance[destination] <= visit->distance[source] + weight) return;
+
+  visit->distance[destination] = visit->distance[source] + weight;
+  visit->parent[destination] = source;
+  h = initializeHeap(16);
+  heapPush(h, destination, visit->distance[destination]);
+  dynamicPropagate(d, h);
+  destroyHeap(h);
+}
+
+/**
+ * The edge (source, destination) has become heavier (or it is gone): if it is a tree edge, all the subtree
+ * of destination loses its distance. Each vertex of the subtree takes the best distance offered by the
+ * vertices outside of the subtree, then the distances are settled with Dijkstra inside the subtree.
+ */
+static void dynamicIncrease(dynamicSSSP *d, int source, int destination) {
+  visitInfo *visit = d->visit;
+  edgenode *adj = NULL;
+  heap *h = NULL;
+  int *affected = NULL;
+  int naffected = 0;
+  int vertex;
+
+  if(visit->parent[destination] != source) return;
+
+  affected = (int *) malloc(sizeof(int) * d->g->size);
+  affected[naffected++] = destination;
+  visit->color[destination] = GRAY;
+  for(int i = 0; i < naffected; i++) {
+    vertex = affected[i];
+    for(adj = d->g->adjList[vertex]; adj != NULL; adj = adj->next) {
+      if(visit->parent[adj->edge] == vertex && visit->color[adj->edge] != GRAY) {
+        visit->color[adj->edge] = GRAY;
+        affected[naffected++] = adj->edge;
+      }
+    }
+  }
+
+  for(int i = 0; i < naffected; i++) {
+    visit->distance[affected[i]] = MAX_DISTANCE;
+    visit->parent[affected[i]] = -1;
+  }
+
+  h = initializeHeap(naffected);
+  for(int i = 0; i < naffected; i++) {
+    vertex = affected[i];
+    for(adj = getIncomingEdges(d->g, vertex); adj != NULL; adj = adj->next) {
+      if(visit->color[adj->edge] != GRAY && visit->distance[adj->edge] != MAX_DISTANCE
+         && visit->distance[vertex] > visit->distance[adj->edge] + adj->weight) {
+        visit->distance[vertex] = visit->distance[adj->edge] + adj->weight;
+        visit->parent[vertex] = adj->edge;
+      }
+    }
+    if(visit->distance[vertex] != MAX_DISTANCE) {
+      heapPush(h, vertex, visit->distance[vertex]);
+    }
+  }
+
+  for(int i = 0; i < naffected; i++) {
+    visit->color[affected[i]] = WHITE;
+  }
+
+  dynamicPropagate(d, h);
+  destroyHeap(h);
+  free(affected);
+}
+
+bool dynamicAddEdge(dynamicSSSP *d, int source, int destination, int weight) {
+  dynamicGrow(d);
+  if(weight < 0 || !addEdgeWeight(d->g, source, destination, weight)) return false;
+
+  dynamicDecrease(d, source, destination, weight);
+  if(!d->g->directed) {
+    dynamicDecrease(d, destination, source, weight);
+  }
+
+  return true;
+}
+
+bool dynamicRemoveEdge(dynamicSSSP *d, int source, int destination) {
+  dynamicGrow(d);
+  if(!removeEdge(d->g, source, destination)) return false;
+
+  dynamicIncrease(d, source, destination);
+  if(!d->g->directed) {
+    dynamicIncrease(d, destination, source);
+  }
+
+  return true;
+}
+
+bool dynamicSetEdgeWeight(dynamicSSSP *d, int source, int destination, int weight) {
+  dynamicGrow(d);
+  int oldWeight = getEdgeWeight(d->g, source, destination);
+
+  if(weight < 0 || !setEdgeWeight(d->g, source, destination, weight)) return false;
+
+  if(weight < oldWeight) {
+    dynamicDecrease(d, source, destination, weight);
+    if(!d->g->directed) {
+      dynamicDecrease(d, destination, source, weight);
+    }
+  } else if(weight > oldWeight) {
+    dynamicIncrease(d, source, destination);
+    if(!d->g->directed) {
+      dynamicIncrease(d, destination, source);
+    }
+  }
+
+  return true;
+}
+
+void destroyDynamicSSSP(dynamicSSSP *d) {
+  if(d->ownsReverseIndex) {
+    disableReverseIndex(d->g);
+  }
+  destroyVisit(d->visit);
+  free(d);
+}
+
+/* DYNAMIC SHORTEST PATH - END */
+
+
+/* BATCH QUERIES - START */
+
+typedef struct queryWorkspace queryWorkspace;
+
+/**
+ * The search state of a query. Between two queries only the touched vertices are reset.
+ */
+struct queryWorkspace {
+  int *distance;
+  int *parent;
+  bool *settled;
+  int *touched;
+  int ntouched;
+  heap *h;
+};
+
+typedef struct queryTask queryTask;
+
+struct queryTask {
+  graph *g;
+  graphQuery *queries;
+};
+
+static void touchVertex(queryWorkspace *w, int vertex, int distance, int parent) {
+  if(w->distance[vertex] == MAX_DISTANCE) {
+    w->touched[w->ntouched++] = vertex;
+  }
+  w->distance[vertex] = distance;
+  w->parent[vertex] = parent;
+}
+
+/**
+ * The touched array is also the queue of the BFS: the vertices are touched in visit order.
+ */
+static bool queryBFS(graph *g, queryWorkspace *w, graphQuery *q) {
+  int head = 0;
+  int vertex;
+
+  touchVertex(w, q->source, 0, -1);
+  while(head < w->ntouched) {
+    if(q->target != -1 && w->distance[q->target] != MAX_DISTANCE) break;
+
+    vertex = w->touched[head++];
+    STATS_ADD(verticesSettled, 1);
+    for(edgenode *adj = g->adjList[vertex]; adj != NULL; adj = adj->next) {
+      STATS_ADD(edgesScanned, 1);
+      if(w->distance[adj->edge] == MAX_DISTANCE) {
+        touchVertex(w, adj->edge, w->distance[vertex] + 1, vertex);
+      }
+    }
+  }
+
+  return true;
+}
+
+static bool queryDijkstra(graph *g, queryWorkspace *w, graphQuery *q) {
+  int vertex;
+
+  w->h->size = 0;
+  touchVertex(w, q->source, 0, -1);
+  heapPush(w->h, q->source, 0);
+  while(w->h->size > 0) {
+    vertex = heapPop(w->h, NULL);
+    if(w->settled[vertex]) continue;
+    w->settled[vertex] = true;
+    STATS_ADD(verticesSettled, 1);
+    if(vertex == q->target) break;
+
+    for(edgenode *adj = g->adjList[vertex]; adj != NULL; adj = adj->next) {
+      STATS_ADD(edgesScanned, 1);
+      if(adj->weight < 0) return false;
+      if(w->distance[adj->edge] > w->distance[vertex] + adj->weight) {
+        STATS_ADD(relaxations, 1);
+        touchVertex(w, adj->edge, w->distance[vertex] + adj->weight, vertex);
+        heapPush(w->h, adj->edge, w->distance[adj->edge]);
+      }
+    }
+  }
+
+  return true;
+}
+
+/**
+ * The BFS times are the ones of getBFS: the k-th vertex taken from the queue starts at 2k and ends at 2k+1.
+ */
+static visitInfo * queryVisit(graph *g, queryWorkspace *w, graphQuery *q) {
+  visitInfo *visit = initializeVisit(g);
+  int vertex;
+
+  for(int i = 0; i < w->ntouched; i++) {
+    vertex = w->touched[i];
+    if(q->type == DIJKSTRA_QUERY && !w->settled[vertex]) continue;
+
+    visit->distance[vertex] = w->distance[vertex];
+    visit->parent[vertex] = w->parent[vertex];
+    visit->color[vertex] = BLACK;
+    if(q->type == BFS_QUERY) {
+      visit->startTime[vertex] = 2 * i;
+      visit->endTime[vertex] = 2 * i + 1;
+    }
+  }
+
+  return visit;
+}
+
+static void queryChunk(int start, int end, void *arg) {
+  queryTask *task = (queryTask *) arg;
+  graph *g = task->g;
+  graphQuery *q = NULL;
+  queryWorkspace w;
+  bool answered;
+
+  w.distance = (int *) malloc(sizeof(int) * (g->size + 1));
+  w.parent = (int *) malloc(sizeof(int) * (g->size + 1));
+  w.settled = (bool *) malloc(sizeof(bool) * (g->size + 1));
+  w.touched = (int *) malloc(sizeof(int) * (g->size + 1));
+  w.ntouched = 0;
+  w.h = initializeHeap(16);
+  for(int v = 0; v < g->size; v++) {
+    w.distance[v] = MAX_DISTANCE;
+    w.parent[v] = -1;
+    w.settled[v] = false;
+  }
+
+  for(int i = start; i < end; i++) {
+    q = &task->queries[i];
+    q->visit = NULL;
+    q->distance = MAX_DISTANCE;
+    q->done = false;
+    if(!containsVertex(g, q->source) || (q->target != -1 && !containsVertex(g, q->target))) continue;
+
+    answered = q->type == BFS_QUERY ? queryBFS(g, &w, q) : queryDijkstra(g, &w, q);
+    if(answered) {
+      if(q->target == -1) {
+        q->visit = queryVisit(g, &w, q);
+      } else {
+        q->distance = w.distance[q->target];
+      }
+      q->done = true;
+    }
+
+    for(int j = 0; j < w.ntouched; j++) {
+      w.distance[w.touched[j]] = MAX_DISTANCE;
+      w.parent[w.touched[j]] = -1;
+      w.settled[w.touched[j]] = false;
+    }
+    w.ntouched = 0;
+  }
+
+  free(w.distance);
+  free(w.parent);
+  free(w.settled);
+  free(w.touched);
+  destroyHeap(w.h);
+}
+
+int runQueryBatch(graph *g, graphQuery *queries, int nqueries) {
+  queryTask task = {g, queries};
+  int answered = 0;
+
+  parallelFor(0, nqueries, queryChunk, &task);
+  for(int i = 0; i < nqueries; i++) {
+    if(queries[i].done) answered += 1;
+  }
+
+  return answered;
+}
+
+/* BATCH QUERIES - END */
+
+
+/* MULTI-SOURCE BFS - START */
+
+#define MSBFS_BATCH 64
+
+typedef struct msbfsTask msbfsTask;
+
+struct msbfsTask {
+  graph *g;
+  int *sources;
+  int nsources;
+  int **distance;
+  bfsSummary *summary;
+};
+
+/**
+ * The work arrays of a chunk of batches: bit i of a mask refers to the i-th source of the batch.
+ */
+typedef struct msbfsWorkspace msbfsWorkspace;
+
+struct msbfsWorkspace {
+  uint64_t *seen;
+  uint64_t *frontier;
+  uint64_t *next;
+  int *current;
+  int *candidates;
+};
+
+static int lowestBit(uint64_t bits) {
+#ifdef __GNUC__
+  return __builtin_ctzll(bits);
+#else
+  int i = 0;
+  while(!(bits & 1)) {
+    bits >>= 1;
+    i++;
+  }
+  return i;
+#endif
+}
+
+static void msbfsReached(msbfsTask *task, int first, uint64_t bits, int vertex, int level) {
+  int source;
+
+  while(bits != 0) {
+    source = first + lowestBit(bits);
+    bits &= bits - 1;
+    if(task->distance != NULL) {
+      task->distance[source][vertex] = level;
+    } else {
+      task->summary[source].distanceSum += level;
+      task->summary[source].reached += 1;
+      task->summary[source].eccentricity = level;
+    }
+  }
+}
+
+/**
+ * Only the vertices whose frontier mask is not empty are expanded, so a level costs the edges of its frontier.
+ */
+static void msbfsBatch(msbfsTask *task, msbfsWorkspace *w, int first, int count) {
+  graph *g = task->g;
+  int ncurrent = 0;
+  int ncandidates;
+  int vertex;
+  int level = 0;
+  uint64_t bits;
+
+  for(int i = 0; i < count; i++) {
+    if(task->distance != NULL) {
+      task->distance[first + i] = (int *) malloc(sizeof(int) * (g->size + 1));
+      for(int v = 0; v < g->size; v++) {
+        task->distance[first + i][v] = MAX_DISTANCE;
+      }
+    } else {
+      task->summary[first + i].distanceSum = 0;
+      task->summary[first + i].reached = 0;
+      task->summary[first + i].eccentricity = 0;
+    }
+
+    vertex = task->sources == NULL ? first + i : task->sources[first + i];
+    if(!containsVertex(g, vertex)) continue;
+    if(w->frontier[vertex] == 0) w->current[ncurrent++] = vertex;
+    w->frontier[vertex] |= (uint64_t) 1 << i;
+    w->seen[vertex] |= (uint64_t) 1 << i;
+  }
+  for(int i = 0; i < ncurrent; i++) {
+    msbfsReached(task, first, w->frontier[w->current[i]], w->current[i], 0);
+  }
+
+  while(ncurrent > 0) {
+    level += 1;
+    ncandidates = 0;
+    for(int i = 0; i < ncurrent; i++) {
+      vertex = w->current[i];
+      bits = w->frontier[vertex];
+      w->frontier[vertex] = 0;
+      STATS_ADD(verticesSettled, 1);
+      for(edgenode *adj = g->adjList[vertex]; adj != NULL; adj = adj->next) {
+        STATS_ADD(edgesScanned, 1);
+        if((bits & ~w->seen[adj->edge]) == 0) continue;
+        if(w->next[adj->edge] == 0) w->candidates[ncandidates++] = adj->edge;
+        w->next[adj->edge] |= bits;
+      }
+    }
+
+    ncurrent = 0;
+    for(int i = 0; i < ncandidates; i++) {
+      vertex = w->candidates[i];
+      bits = w->next[vertex] & ~w->seen[vertex];
+      w->next[vertex] = 0;
+      w->seen[vertex] |= bits;
+      w->frontier[vertex] = bits;
+      w->current[ncurrent++] = vertex;
+      msbfsReached(task, first, bits, vertex, level);
+    }
+  }
+
+  memset(w->seen, 0, sizeof(uint64_t) * g->size);
+}
+
+static void msbfsChunk(int start, int end, void *arg) {
+  msbfsTask *task = (msbfsTask *) arg;
+  int size = task->g->size + 1;
+  msbfsWorkspace w;
+  int first;
+
+  w.seen = (uint64_t *) calloc(size, sizeof(uint64_t));
+  w.frontier = (uint64_t *) calloc(size, sizeof(uint64_t));
+  w.next = (uint64_t *) calloc(size, sizeof(uint64_t));
+  w.current = (int *) malloc(sizeof(int) * size);
+  w.candidates = (int *) malloc(sizeof(int) * size);
+
+  for(int batch = start; batch < end; batch++) {
+    first = batch * MSBFS_BATCH;
+    msbfsBatch(task, &w, first, task->nsources - first < MSBFS_BATCH ? task->nsources - first : MSBFS_BATCH);
+  }
+
+  free(w.seen);
+  free(w.frontier);
+  free(w.next);
+  free(w.current);
+  free(w.candidates);
+}
+
+static void runMultiSourceBFS(msbfsTask *task) {
+  int nbatches = (task->nsources + MSBFS_BATCH - 1) / MSBFS_BATCH;
+
+  parallelForGrain(0, nbatches, nbatches / getNumberOfThreads() + 1, msbfsChunk, task);
+}
+
+int ** getMultiSourceBFS(graph *g, int *sources, int nsources) {
+  msbfsTask task = {g, sources, sources == NULL ? g->size : nsources, NULL, NULL};
+
+  task.distance = (int **) malloc(sizeof(int *) * (task.nsources + 1));
+  runMultiSourceBFS(&task);
+
+  return task.distance;
+}
+
+bfsSummary * getMultiSourceBFSSummary(graph *g, int *sources, int nsources) {
+  msbfsTask task = {g, sources, sources == NULL ? g->size : nsources, NULL, NULL};
+
+  task.summary = (bfsSummary *) malloc(sizeof(bfsSummary) * (task.nsources + 1));
+  runMultiSourceBFS(&task);
+
+  return task.summary;
+}
+
+/* MULTI-SOURCE BFS - END */
+
+
+/* CENTRALITY - START */
+
+typedef struct centralityTask centralityTask;
+
+/**
+ * The shared state of a centrality computation: the chunks of sources accumulate in a buffer for each thread
+ * (the centrality, or the distance sums followed by the reached counts), and the buffers are summed at the end.
+ */
+struct centralityTask {
+  graph *g;
+  int *sources;
+  bool weighted;
+  bool betweenness;
+  double *centrality;
+  long long *distanceSum;
+  int *reached;
+  workerBuffers *buffers;
+  void **partial;
+  int npartial;
+};
+
+typedef struct centralityWorkspace centralityWorkspace;
+
+struct centralityWorkspace {
+  int *distance;
+  double *sigma;
+  double *delta;
+  bool *settled;
+  int *order;
+  int norder;
+  heap *h;
+};
+
+static bool hasNegativeWeight(graph *g) {
+  for(int v = 0; v < g->size; v++) {
+    for(edgenode *adj = g->adjList[v]; adj != NULL; adj = adj->next) {
+      if(adj->weight < 0) return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Selects the sources among the vertices of the graph: all of them, or a random subset of samples vertices.
+ */
+static int * getCentralitySources(graph *g, int samples, unsigned int seed, int *nsources) {
+  int n = countVertices(g);
+  int *sources = (int *) malloc(sizeof(int) * (n + 1));
+  int count = 0;
+  int j, tmp;
+
+  for(int v = 0; v < g->size; v++) {
+    if(containsVertex(g, v)) sources[count++] = v;
+  }
+  *nsources = samples <= 0 || samples >= count ? count : samples;
+
+  // Partial Fisher-Yates shuffle
+  for(int i = 0; i < *nsources && *nsources < count; i++) {
+    seed = seed * 1103515245 + 12345;
+    j = i + (int) ((seed >> 8) % (unsigned int) (count - i));
+    tmp = sources[i];
+    sources[i] = sources[j];
+    sources[j] = tmp;
+  }
+
+  return sources;
+}
+
+/**
+ * Settles the vertices reachable from the source, counting the shortest paths that reach each of them. The order
+ * array contains the settled vertices by non-decreasing distance.
+ */
+static void centralitySearch(graph *g, centralityWorkspace *w, int source, bool weighted) {
+  int head = 0;
+  int vertex, length;
+
+  w->norder = 0;
+  w->distance[source] = 0;
+  w->sigma[source] = 1;
+  if(!weighted) {
+    w->settled[source] = true;
+    w->order[w->norder++] = source;
+  } else {
+    w->h->size = 0;
+    heapPush(w->h, source, 0);
+  }
+
+  while(weighted ? w->h->size > 0 : head < w->norder) {
+    if(!weighted) {
+      vertex = w->order[head++];
+    } else {
+      vertex = heapPop(w->h, NULL);
+      if(w->settled[vertex]) continue;
+      w->settled[vertex] = true;
+      w->order[w->norder++] = vertex;
+    }
+    STATS_ADD(verticesSettled, 1);
+
+    for(edgenode *adj = g->adjList[vertex]; adj != NULL; adj = adj->next) {
+      STATS_ADD(edgesScanned, 1);
+      length = weighted ? adj->weight : 1;
+      if(w->distance[adj->edge] > w->distance[vertex] + length) {
+        STATS_ADD(relaxations, 1);
+        w->distance[adj->edge] = w->distance[vertex] + length;
+        w->sigma[adj->edge] = w->sigma[vertex];
+        if(!weighted) {
+          w->settled[adj->edge] = true;
+          w->order[w->norder++] = adj->edge;
+        } else {
+          heapPush(w->h, adj->edge, w->distance[adj->edge]);
+        }
+      } else if(w->distance[adj->edge] == w->distance[vertex] + length && (!weighted || !w->settled[adj->edge])) {
+        w->sigma[adj->edge] += w->sigma[vertex];
+      }
+    }
+  }
+}
+
+/**
+ * Walks the settled vertices in reverse order: an edge (v, u) is on a shortest path if u has been settled after v
+ * (so it has already been walked and reset) and the distances match. Once the dependency of u is known, delta
+ * keeps (1 + dependency) / sigma, the factor its predecessors multiply by their own sigma.
+ */
+static void accumulateDependencies(graph *g, centralityWorkspace *w, int source, bool weighted, double *centrality) {
+  int vertex, length;
+  double sum;
+
+  for(int i = w->norder - 1; i >= 0; i--) {
+    vertex = w->order[i];
+    sum = 0;
+    for(edgenode *adj = g->adjList[vertex]; adj != NULL; adj = adj->next) {
+      length = weighted ? adj->weight : 1;
+      if(!w->settled[adj->edge] && w->sigma[adj->edge] > 0 && w->distance[adj->edge] == w->distance[vertex] + length) {
+        sum += w->delta[adj->edge];
+      }
+    }
+    w->settled[vertex] = false;
+    if(vertex != source) centrality[vertex] += w->sigma[vertex] * sum;
+    w->delta[vertex] = (1 + w->sigma[vertex] * sum) / w->sigma[vertex];
+  }
+}
+
+static void centralityChunk(int start, int end, void *arg) {
+  centralityTask *task = (centralityTask *) arg;
+  graph *g = task->g;
+  centralityWorkspace w;
+  double *centrality = NULL;
+  long long *distanceSum = NULL;
+  int *reached = NULL;
+  int vertex;
+
+  w.distance = (int *) malloc(sizeof(int) * (g->size + 1));
+  w.sigma = (double *) calloc(g->size + 1, sizeof(double));
+  w.delta = (double *) calloc(g->size + 1, sizeof(double));
+  w.settled = (bool *) calloc(g->size + 1, sizeof(bool));
+  w.order = (int *) malloc(sizeof(int) * (g->size + 1));
+  w.h = initializeHeap(16);
+  for(int v = 0; v < g->size; v++) {
+    w.distance[v] = MAX_DISTANCE;
+  }
+  if(task->betweenness) {
+    centrality = (double *) acquireWorkerBuffer(task->buffers);
+  } else {
+    distanceSum = (long long *) acquireWorkerBuffer(task->buffers);
+    reached = (int *) (distanceSum + g->size + 1);
+  }
+
+  for(int i = start; i < end; i++) {
+    centralitySearch(g, &w, task->sources[i], task->weighted);
+    if(task->betweenness) {
+      accumulateDependencies(g, &w, task->sources[i], task->weighted, centrality);
+    }
+
+    for(int j = 0; j < w.norder; j++) {
+      vertex = w.order[j];
+      if(!task->betweenness && vertex != task->sources[i]) {
+        distanceSum[vertex] += w.distance[vertex];
+        reached[vertex] += 1;
+      }
+      w.distance[vertex] = MAX_DISTANCE;
+      w.sigma[vertex] = 0;
+      w.delta[vertex] = 0;
+      w.settled[vertex] = false;
+    }
+  }
+
+  releaseWorkerBuffer(task->buffers, task->betweenness ? (void *) centrality : (void *) distanceSum);
+
+  free(w.distance);
+  free(w.sigma);
+  free(w.delta);
+  free(w.settled);
+  free(w.order);
+  destroyHeap(w.h);
+}
+
+static void mergeCentralityChunk(int start, int end, void *arg) {
+  centralityTask *task = (centralityTask *) arg;
+  int size = task->g->size;
+  long long *distanceSum = NULL;
+
+  for(int v = start; v < end; v++) {
+    for(int i = 0; i < task->npartial; i++) {
+      if(task->betweenness) {
+        task->centrality[v] += ((double *) task->partial[i])[v];
+      } else {
+        distanceSum = (long long *) task->partial[i];
+        task->distanceSum[v] += distanceSum[v];
+        task->reached[v] += ((int *) (distanceSum + size + 1))[v];
+      }
+    }
+  }
+}
+
+/**
+ * Runs the chunks of sources, then sums the buffers of the threads into the result.
+ */
+static void runCentralityTask(centralityTask *task, int nsources) {
+  size_t bytes = task->betweenness ? sizeof(double) : sizeof(long long) + sizeof(int);
+
+  task->buffers = initializeWorkerBuffers(bytes * (task->g->size + 1));
+  parallelFor(0, nsources, centralityChunk, task);
+  task->partial = getWorkerBuffers(task->buffers, &task->npartial);
+  parallelFor(0, task->g->size, mergeCentralityChunk, task);
+  free(task->partial);
+  destroyWorkerBuffers(task->buffers);
+}
+
+double * getBetweennessCentrality(graph *g, bool weighted, int samples, unsigned int seed) {
+  centralityTask task = {g, NULL, weighted, true, NULL, NULL, NULL, NULL, NULL, 0};
+  int nsources, n;
+  double scale;
+
+  if(weighted && hasNegativeWeight(g)) return NULL;
+
+  task.sources = getCentralitySources(g, samples, seed, &nsources);
+  task.centrality = (double *) calloc(g->size + 1, sizeof(double));
+  runCentralityTask(&task, nsources);
+
+  n = countVertices(g);
+  scale = (nsources > 0 ? (double) n / nsources : 1) * (g->directed ? 1 : 0.5);
+  for(int v = 0; v < g->size; v++) {
+    task.centrality[v] *= scale;
+  }
+
+  free(task.sources);
+  return task.centrality;
+}
+
+double * getClosenessCentrality(graph *g, bool weighted, int samples, unsigned int seed) {
+  centralityTask task = {NULL, NULL, weighted, false, NULL, NULL, NULL, NULL, NULL, 0};
+  double *closeness = NULL;
+  bfsSummary *summary = NULL;
+  bool *sampled = NULL;
+  int nsources, others;
+
+  if(weighted && hasNegativeWeight(g)) return NULL;
+
+  task.sources = getCentralitySources(g, samples, seed, &nsources);
+  closeness = (double *) calloc(g->size + 1, sizeof(double));
+
+  // Exact unweighted closeness: one multi-source visit from every vertex
+  if(!weighted && nsources == countVertices(g)) {
+    summary = getMultiSourceBFSSummary(g, NULL, 0);
+    for(int v = 0; v < g->size; v++) {
+      if(summary[v].distanceSum > 0) {
+        closeness[v] = (double) (summary[v].reached - 1) * (summary[v].reached - 1) / ((double) (nsources - 1) * summary[v].distanceSum);
+      }
+    }
+    free(summary);
+    free(task.sources);
+    return closeness;
+  }
+
+  // The distances to the sources are the distances from the sources in the transposed graph
+  task.g = g->directed ? getTransposedGraph(g) : g;
+  task.distanceSum = (long long *) calloc(g->size + 1, sizeof(long long));
+  task.reached = (int *) calloc(g->size + 1, sizeof(int));
+  sampled = (bool *) calloc(g->size + 1, sizeof(bool));
+  for(int i = 0; i < nsources; i++) {
+    sampled[task.sources[i]] = true;
+  }
+  runCentralityTask(&task, nsources);
+
+  for(int v = 0; v < g->size; v++) {
+    others = nsources - (sampled[v] ? 1 : 0);
+    if(task.distanceSum[v] > 0 && others > 0) {
+      closeness[v] = (double) task.reached[v] * task.reached[v] / ((double) others * task.distanceSum[v]);
+    }
+  }
+
+  if(task.g != g) destroyGraph(task.g);
+  free(task.distanceSum);
+  free(task.reached);
+  free(sampled);
+  free(task.sources);
+  return closeness;
+}
+
+/* CENTRALITY - END */
+
+
+/* PAGERANK - START */
+
+typedef struct pageRankTask pageRankTask;
+
+/**
+ * The state of the power iteration: contribution holds the rank each vertex gives to every out-neighbour.
+ */
+struct pageRankTask {
+  csrGraph *in;
+  int *outDegree;
+  double *jump;
+  double *rank;
+  double *next;
+  double *contribution;
+  double damping;
+  double dangling;
+  double change;
+  pthread_mutex_t lock;
+};
+
+/**
+ * Copies the incoming edges of each vertex in contiguous arrays with a counting sort, and counts the out-degrees.
+ */
+static csrGraph * getIncomingCSR(graph *g, int *outDegree) {
+  csrGraph *c = (csrGraph *) malloc(sizeof(csrGraph));
+  size_t *position = NULL;
+  size_t pos;
+
+  c->size = g->size;
+  c->directed = g->directed;
+  c->offset = (size_t *) calloc(g->size + 1, sizeof(size_t));
+  for(int v = 0; v < g->size; v++) {
+    outDegree[v] = 0;
+    for(edgenode *adj = g->adjList[v]; adj != NULL; adj = adj->next) {
+      c->offset[adj->edge + 1] += 1;
+      outDegree[v] += 1;
+    }
+  }
+  for(int v = 0; v < g->size; v++) {
+    c->offset[v + 1] += c->offset[v];
+  }
+
+  c->target = (int *) malloc(sizeof(int) * (c->offset[g->size] > 0 ? c->offset[g->size] : 1));
+  c->weight = (int *) malloc(sizeof(int) * (c->offset[g->size] > 0 ? c->offset[g->size] : 1));
+  position = (size_t *) malloc(sizeof(size_t) * (g->size + 1));
+  memcpy(position, c->offset, sizeof(size_t) * (g->size + 1));
+  for(int v = 0; v < g->size; v++) {
+    for(edgenode *adj = g->adjList[v]; adj != NULL; adj = adj->next) {
+      pos = position[adj->edge]++;
+      c->target[pos] = v;
+      c->weight[pos] = adj->weight;
+    }
+  }
+
+  free(position);
+  return c;
+}
+
+static void pageRankContributions(int start, int end, void *arg) {
+  pageRankTask *task = (pageRankTask *) arg;
+  double dangling = 0;
+
+  for(int v = start; v < end; v++) {
+    if(task->outDegree[v] > 0) {
+      task->contribution[v] = task->rank[v] / task->outDegree[v];
+    } else {
+      task->contribution[v] = 0;
+      dangling += task->rank[v];
+    }
+  }
+
+  pthread_mutex_lock(&task->lock);
+  task->dangling += dangling;
+  pthread_mutex_unlock(&task->lock);
+}
+
+static void pageRankPull(int start, int end, void *arg) {
+  pageRankTask *task = (pageRankTask *) arg;
+  double base = 1 - task->damping + task->damping * task->dangling;
+  double change = 0;
+  double sum;
+
+  for(int v = start; v < end; v++) {
+    sum = 0;
+    for(size_t i = task->in->offset[v]; i < task->in->offset[v + 1]; i++) {
+      sum += task->contribution[task->in->target[i]];
+    }
+    STATS_ADD(edgesScanned, task->in->offset[v + 1] - task->in->offset[v]);
+    task->next[v] = base * task->jump[v] + task->damping * sum;
+    change += task->next[v] > task->rank[v] ? task->next[v] - task->rank[v] : task->rank[v] - task->next[v];
+  }
+
+  pthread_mutex_lock(&task->lock);
+  task->change += change;
+  pthread_mutex_unlock(&task->lock);
+}
+
+double * getPageRank(graph *g, double damping, double tolerance, int maxIterations, int *iterations) {
+  return getPersonalizedPageRank(g, NULL, damping, tolerance, maxIterations, iterations);
+}
+
+double * getPersonalizedPageRank(graph *g, double *personalization, double damping, double tolerance, int maxIterations, int *iterations) {
+  pageRankTask task;
+  double total = 0;
+  double *tmp = NULL;
+  int iteration = 0;
+
+  task.jump = (double *) malloc(sizeof(double) * (g->size + 1));
+  for(int v = 0; v < g->size; v++) {
+    task.jump[v] = !containsVertex(g, v) ? 0 : (personalization == NULL ? 1 : personalization[v]);
+    if(task.jump[v] < 0) total = -1;
+    if(total >= 0) total += task.jump[v];
+  }
+  if(total <= 0) {
+    free(task.jump);
+    return NULL;
+  }
+
+  task.outDegree = (int *) malloc(sizeof(int) * (g->size + 1));
+  task.in = getIncomingCSR(g, task.outDegree);
+  task.rank = (double *) malloc(sizeof(double) * (g->size + 1));
+  task.next = (double *) malloc(sizeof(double) * (g->size + 1));
+  task.contribution = (double *) malloc(sizeof(double) * (g->size + 1));
+  task.damping = damping;
+  pthread_mutex_init(&task.lock, NULL);
+  for(int v = 0; v < g->size; v++) {
+    task.jump[v] /= total;
+    task.rank[v] = task.jump[v];
+  }
+
+  while(iteration < maxIterations) {
+    task.dangling = 0;
+    task.change = 0;
+    parallelFor(0, g->size, pageRankContributions, &task);
+    parallelFor(0, g->size, pageRankPull, &task);
+    tmp = task.rank;
+    task.rank = task.next;
+    task.next = tmp;
+    iteration += 1;
+    if(task.change < tolerance) break;
+  }
+
+  if(iterations != NULL) *iterations = iteration;
+  pthread_mutex_destroy(&task.lock);
+  destroyCSRGraph(task.in);
+  free(task.outDegree);
+  free(task.jump);
+  free(task.next);
+  free(task.contribution);
+  return task.rank;
+}
+
+typedef struct pushState pushState;
+
+/**
+ * The state of the residual push. The queue is circular and holds a vertex at most once. The out-degrees are
+ * counted the first time a vertex is met and cached as degree + 1 (0 means not counted yet).
+ */
+struct pushState {
+  graph *g;
+  double *residual;
+  int *degree;
+  int *queue;
+  bool *queued;
+  int tail;
+  double epsilon;
+};
+
+static int cachedOutDegree(pushState *p, int vertex) {
+  if(p->degree[vertex] == 0) {
+    p->degree[vertex] = 1;
+    for(edgenode *adj = p->g->adjList[vertex]; adj != NULL; adj = adj->next) {
+      p->degree[vertex] += 1;
+    }
+  }
+
+  return p->degree[vertex] - 1;
+}
+
+static void addResidual(pushState *p, int vertex, double mass) {
+  int outDegree;
+
+  p->residual[vertex] += mass;
+  if(p->queued[vertex]) return;
+
+  outDegree = cachedOutDegree(p, vertex);
+  if(p->residual[vertex] > p->epsilon * (outDegree > 0 ? outDegree : 1)) {
+    p->queue[p->tail] = vertex;
+    p->tail = (p->tail + 1) % (p->g->size + 1);
+    p->queued[vertex] = true;
+  }
+}
+
+double * getPushPersonalizedPageRank(graph *g, int source, double damping, double epsilon, int *pushes) {
+  pushState p;
+  double *rank = NULL;
+  int head = 0;
+  int count = 0;
+  int vertex, outDegree;
+  double mass;
+
+  if(!containsVertex(g, source)) return NULL;
+
+  rank = (double *) calloc(g->size + 1, sizeof(double));
+  p.g = g;
+  p.residual = (double *) calloc(g->size + 1, sizeof(double));
+  p.degree = (int *) calloc(g->size + 1, sizeof(int));
+  p.queue = (int *) malloc(sizeof(int) * (g->size + 1));
+  p.queued = (bool *) calloc(g->size + 1, sizeof(bool));
+  p.tail = 0;
+  p.epsilon = 0;
+
+  addResidual(&p, source, 1);
+  p.epsilon = epsilon;
+  while(head != p.tail) {
+    vertex = p.queue[head];
+    head = (head + 1) % (g->size + 1);
+    p.queued[vertex] = false;
+
+    outDegree = cachedOutDegree(&p, vertex);
+    mass = p.residual[vertex];
+    p.residual[vertex] = 0;
+    rank[vertex] += (1 - damping) * mass;
+    count += 1;
+
+    // The rank that would leave a vertex without outgoing edges jumps back to the source
+    if(outDegree == 0) {
+      addResidual(&p, source, damping * mass);
+    }
+    for(edgenode *adj = g->adjList[vertex]; adj != NULL; adj = adj->next) {
+      STATS_ADD(edgesScanned, 1);
+      addResidual(&p, adj->edge, damping * mass / outDegree);
+    }
+  }
+
+  if(pushes != NULL) *pushes = count;
+  free(p.residual);
+  free(p.degree);
+  free(p.queue);
+  free(p.queued);
+  return rank;
+}
+
+/* PAGERANK - END */
+
+
+/* TRIANGLES - START */
+
+typedef struct triangleTask triangleTask;
+
+struct triangleTask {
+  csrGraph *oriented;
+  long long *vertexTriangles;
+  workerBuffers *buffers;
+  long long **partial;
+  int npartial;
+  long long triangles;
+  pthread_mutex_t lock;
+};
+
+/**
+ * Counts the neighbours of each vertex other than itself.
+ */
+static int * getSimpleDegrees(graph *g) {
+  int *degree = (int *) calloc(g->size + 1, sizeof(int));
+
+  for(int v = 0; v < g->size; v++) {
+    for(edgenode *adj = g->adjList[v]; adj != NULL; adj = adj->next) {
+      if(adj->edge != v) degree[v] += 1;
+    }
+  }
+
+  return degree;
+}
+
+static inline bool orientedBefore(int *degree, int a, int b) {
+  return degree[a] < degree[b] || (degree[a] == degree[b] && a < b);
+}
+
+/**
+ * Keeps each edge once, from the endpoint that comes first in the degree order. The lists are filled scanning the
+ * vertices by increasing index, so they come out sorted.
+ */
+static csrGraph * getOrientedCSR(graph *g, int *degree) {
+  csrGraph *c = (csrGraph *) malloc(sizeof(csrGraph));
+  size_t *position = NULL;
+
+  c->size = g->size;
+  c->directed = true;
+  c->weight = NULL;
+  c->offset = (size_t *) calloc(g->size + 1, sizeof(size_t));
+  for(int v = 0; v < g->size; v++) {
+    for(edgenode *adj = g->adjList[v]; adj != NULL; adj = adj->next) {
+      if(adj->edge != v && orientedBefore(degree, v, adj->edge)) c->offset[v + 1] += 1;
+    }
+  }
+  for(int v = 0; v < g->size; v++) {
+    c->offset[v + 1] += c->offset[v];
+  }
+
+  c->target = (int *) malloc(sizeof(int) * (c->offset[g->size] > 0 ? c->offset[g->size] : 1));
+  position = (size_t *) malloc(sizeof(size_t) * (g->size + 1));
+  memcpy(position, c->offset, sizeof(size_t) * (g->size + 1));
+  for(int u = 0; u < g->size; u++) {
+    for(edgenode *adj = g->adjList[u]; adj != NULL; adj = adj->next) {
+      if(adj->edge != u && orientedBefore(degree, adj->edge, u)) c->target[position[adj->edge]++] = u;
+    }
+  }
+
+  free(position);
+  return c;
+}
+
+/**
+ * Returns the first position from lo whose value is not less than x, doubling the step and then halving it.
+ */
+static size_t gallop(int *list, size_t lo, size_t n, int x) {
+  size_t step = 1;
+  size_t hi, mid;
+
+  while(lo + step < n && list[lo + step] < x) {
+    step *= 2;
+  }
+  hi = lo + step < n ? lo + step : n;
+  lo += step / 2;
+  while(lo < hi) {
+    mid = lo + (hi - lo) / 2;
+    if(list[mid] < x) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  return lo;
+}
+
+/**
+ * Intersects two sorted lists, adding a triangle to each common vertex. A merge is used when the lists have similar
+ * lengths, otherwise each element of the shorter list is searched in the longer one.
+ */
+static long long intersectSorted(int *a, size_t na, int *b, size_t nb, long long *vertexTriangles) {
+  long long common = 0;
+  size_t i = 0;
+  size_t j = 0;
+  int *tmp = NULL;
+  size_t tmpSize;
+
+  if(na > nb) {
+    tmp = a;
+    a = b;
+    b = tmp;
+    tmpSize = na;
+    na = nb;
+    nb = tmpSize;
+  }
+
+  if(na * 32 < nb) {
+    for(i = 0; i < na && j < nb; i++) {
+      j = gallop(b, j, nb, a[i]);
+      if(j < nb && b[j] == a[i]) {
+        common += 1;
+        if(vertexTriangles != NULL) vertexTriangles[a[i]] += 1;
+      }
+    }
+    return common;
+  }
+
+  while(i < na && j < nb) {
+    if(a[i] < b[j]) {
+      i++;
+    } else if(a[i] > b[j]) {
+      j++;
+    } else {
+      common += 1;
+      if(vertexTriangles != NULL) vertexTriangles[a[i]] += 1;
+      i++;
+      j++;
+    }
+  }
+
+  return common;
+}
+
+static void triangleChunk(int start, int end, void *arg) {
+  triangleTask *task = (triangleTask *) arg;
+  csrGraph *c = task->oriented;
+  long long *vertexTriangles = NULL;
+  long long triangles = 0;
+  long long common;
+  int v;
+
+  if(task->vertexTriangles != NULL) vertexTriangles = (long long *) acquireWorkerBuffer(task->buffers);
+
+  for(int u = start; u < end; u++) {
+    for(size_t i = c->offset[u]; i < c->offset[u + 1]; i++) {
+      v = c->target[i];
+      STATS_ADD(edgesScanned, 1);
+      common = intersectSorted(c->target + c->offset[u], c->offset[u + 1] - c->offset[u], c->target + c->offset[v], c->offset[v + 1] - c->offset[v], vertexTriangles);
+      triangles += common;
+      if(vertexTriangles != NULL) {
+        vertexTriangles[u] += common;
+        vertexTriangles[v] += common;
+      }
+    }
+  }
+
+  if(vertexTriangles != NULL) releaseWorkerBuffer(task->buffers, vertexTriangles);
+  pthread_mutex_lock(&task->lock);
+  task->triangles += triangles;
+  pthread_mutex_unlock(&task->lock);
+}
+
+static void mergeTrianglesChunk(int start, int end, void *arg) {
+  triangleTask *task = (triangleTask *) arg;
+
+  for(int v = start; v < end; v++) {
+    task->vertexTriangles[v] = 0;
+    for(int i = 0; i < task->npartial; i++) {
+      task->vertexTriangles[v] += task->partial[i][v];
+    }
+  }
+}
+
+/**
+ * The triangles of each vertex are counted in a buffer for each thread, and the buffers are summed at the end.
+ */
+static long long countTriangles(graph *g, int *degree, long long *vertexTriangles) {
+  triangleTask task = {NULL, vertexTriangles, NULL, NULL, 0, 0, PTHREAD_MUTEX_INITIALIZER};
+
+  if(vertexTriangles != NULL) {
+    task.buffers = initializeWorkerBuffers(sizeof(long long) * (g->size + 1));
+  }
+  task.oriented = getOrientedCSR(g, degree);
+  parallelFor(0, g->size, triangleChunk, &task);
+
+  if(vertexTriangles != NULL) {
+    task.partial = (long long **) getWorkerBuffers(task.buffers, &task.npartial);
+    parallelFor(0, g->size, mergeTrianglesChunk, &task);
+    free(task.partial);
+    destroyWorkerBuffers(task.buffers);
+  }
+  destroyCSRGraph(task.oriented);
+  pthread_mutex_destroy(&task.lock);
+  return task.triangles;
+}
+
+long long getTriangleCount(graph *g, long long *vertexTriangles) {
+  int *degree = NULL;
+  long long triangles;
+
+  if(g->directed) return -1;
+
+  degree = getSimpleDegrees(g);
+  triangles = countTriangles(g, degree, vertexTriangles);
+
+  free(degree);
+  return triangles;
+}
+
+double * getClusteringCoefficients(graph *g) {
+  double *coefficients = NULL;
+  long long *vertexTriangles = NULL;
+  int *degree = NULL;
+
+  if(g->directed) return NULL;
+
+  degree = getSimpleDegrees(g);
+  vertexTriangles = (long long *) malloc(sizeof(long long) * (g->size + 1));
+  countTriangles(g, degree, vertexTriangles);
+  coefficients = (double *) malloc(sizeof(double) * (g->size + 1));
+  for(int v = 0; v < g->size; v++) {
+    coefficients[v] = degree[v] < 2 ? 0 : 2.0 * vertexTriangles[v] / ((double) degree[v] * (degree[v] - 1));
+  }
+
+  free(degree);
+  free(vertexTriangles);
+  return coefficients;
+}
+
+double getTransitivity(graph *g) {
+  int *degree = NULL;
+  long long triangles;
+  long long paths = 0;
+
+  if(g->directed) return -1;
+
+  degree = getSimpleDegrees(g);
+  triangles = countTriangles(g, degree, NULL);
+  for(int v = 0; v < g->size; v++) {
+    paths += (long long) degree[v] * (degree[v] - 1) / 2;
+  }
+
+  free(degree);
+  return paths == 0 ? 0 : 3.0 * triangles / paths;
+}
+
+/* TRIANGLES - END */
+
+
+/* K-CORE - START */
+
+int * getCoreNumbers(graph *g, int *degeneracy) {
+  int *core = NULL;
+  int *bin = NULL;
+  int *pos = NULL;
+  int *vert = NULL;
+  int maxDegree = 0;
+  int start = 0;
+  int count, vertex, u, du, pu, pw, w;
+
+  if(g->directed) return NULL;
+
+  // The current degree of each vertex becomes its core number when the vertex is removed
+  core = getSimpleDegrees(g);
+  for(int v = 0; v < g->size; v++) {
+    if(core[v] > maxDegree) maxDegree = core[v];
+  }
+
+  // bin[d] is the position in vert of the first vertex with current degree d
+  bin = (int *) calloc(maxDegree + 2, sizeof(int));
+  pos = (int *) malloc(sizeof(int) * (g->size + 1));
+  vert = (int *) malloc(sizeof(int) * (g->size + 1));
+  for(int v = 0; v < g->size; v++) {
+    bin[core[v]] += 1;
+  }
+  for(int d = 0; d <= maxDegree; d++) {
+    count = bin[d];
+    bin[d] = start;
+    start += count;
+  }
+  for(int v = 0; v < g->size; v++) {
+    pos[v] = bin[core[v]];
+    vert[pos[v]] = v;
+    bin[core[v]] += 1;
+  }
+  for(int d = maxDegree; d > 0; d--) {
+    bin[d] = bin[d - 1];
+  }
+  bin[0] = 0;
+
+  for(int i = 0; i < g->size; i++) {
+    vertex = vert[i];
+    STATS_ADD(verticesSettled, 1);
+    for(edgenode *adj = g->adjList[vertex]; adj != NULL; adj = adj->next) {
+      STATS_ADD(edgesScanned, 1);
+      u = adj->edge;
+      if(u == vertex || core[u] <= core[vertex]) continue;
+
+      // Swap u with the first vertex of its bucket, then shrink the bucket from the left
+      du = core[u];
+      pu = pos[u];
+      pw = bin[du];
+      w = vert[pw];
+      if(u != w) {
+        pos[u] = pw;
+        vert[pu] = w;
+        pos[w] = pu;
+        vert[pw] = u;
+      }
+      bin[du] += 1;
+      core[u] -= 1;
+    }
+  }
+
+  if(degeneracy != NULL) {
+    *degeneracy = 0;
+    for(int v = 0; v < g->size; v++) {
+      if(core[v] > *degeneracy) *degeneracy = core[v];
+    }
+  }
+
+  free(bin);
+  free(pos);
+  free(vert);
+  return core;
+}
+
+graph * getKCore(graph *g, int k, int **newId) {
+  graph *kcore = NULL;
+  int *core = getCoreNumbers(g, NULL);
+  int *id = NULL;
+  int size = 0;
+  edgenode *tail = NULL;
+  edgenode *node = NULL;
+
+  if(core == NULL) return NULL;
+
+  id = (int *) malloc(sizeof(int) * (g->size + 1));
+  for(int v = 0; v < g->size; v++) {
+    id[v] = containsVertex(g, v) && core[v] >= k ? size++ : -1;
+  }
+
+  kcore = initializeGraph(false);
+  addVertex(kcore, size);
+  for(int v = 0; v < g->size; v++) {
+    if(id[v] == -1) continue;
+
+    tail = NULL;
+    for(edgenode *adj = g->adjList[v]; adj != NULL; adj = adj->next) {
+      if(id[adj->edge] == -1) continue;
+
+      node = (edgenode *) malloc(sizeof(edgenode));
+      node->edge = id[adj->edge];
+      node->weight = adj->weight;
+      node->next = NULL;
+      if(tail == NULL) {
+        kcore->adjList[id[v]] = node;
+      } else {
+        tail->next = node;
+      }
+      tail = node;
+    }
+  }
+
+  free(core);
+  if(newId != NULL) {
+    *newId = id;
+  } else {
+    free(id);
+  }
+  return kcore;
+}
+
+/* K-CORE - END */
+
+
+/* BICONNECTED COMPONENTS - START */
+
+typedef struct lowLinkFrame lowLinkFrame;
+
+/**
+ * A vertex on the depth-first-search stack: next is the next edge to look at, slot its position among all the
+ * adjacency lists, treeSlot the position of the edge from the parent (-1 for the roots).
+ */
+struct lowLinkFrame {
+  int vertex;
+  int parent;
+  edgenode *next;
+  int slot;
+  int treeSlot;
+  int treeWeight;
+};
+
+static void setLowLinkFrame(lowLinkFrame *frame, graph *g, int *offset, int vertex, int parent, int treeSlot, int treeWeight) {
+  frame->vertex = vertex;
+  frame->parent = parent;
+  frame->next = g->adjList[vertex];
+  frame->slot = offset[vertex];
+  frame->treeSlot = treeSlot;
+  frame->treeWeight = treeWeight;
+}
+
+biconnectedComponents * getBiconnectedComponents(graph *g) {
+  biconnectedComponents *b = NULL;
+  lowLinkFrame *stack = NULL;
+  lowLinkFrame *top = NULL;
+  int *offset = NULL;
+  int *component = NULL;
+  int *edgeStack = NULL;
+  int *disc = NULL;
+  int *low = NULL;
+  bool *articulation = NULL;
+  int nslots = 0;
+  int nstack = 0;
+  int nedgeStack = 0;
+  int time = 0;
+  int rootChildren, vertex, parent, slot;
+  edgenode *adj = NULL;
+
+  if(g->directed) return NULL;
+
+  offset = (int *) malloc(sizeof(int) * (g->size + 1));
+  for(int v = 0; v < g->size; v++) {
+    offset[v] = nslots;
+    for(adj = g->adjList[v]; adj != NULL; adj = adj->next) {
+      nslots += 1;
+    }
+  }
+  offset[g->size] = nslots;
+
+  b = (biconnectedComponents *) malloc(sizeof(biconnectedComponents));
+  b->nedges = 0;
+  b->ncomponents = 0;
+  b->nbridges = 0;
+  b->narticulationPoints = 0;
+  b->bridges = (weightedEdge *) malloc(sizeof(weightedEdge) * (g->size + 1));
+  b->articulationPoints = (int *) malloc(sizeof(int) * (g->size + 1));
+
+  component = (int *) malloc(sizeof(int) * (nslots + 1));
+  edgeStack = (int *) malloc(sizeof(int) * (nslots + 1));
+  stack = (lowLinkFrame *) malloc(sizeof(lowLinkFrame) * (g->size + 1));
+  disc = (int *) malloc(sizeof(int) * (g->size + 1));
+  low = (int *) malloc(sizeof(int) * (g->size + 1));
+  articulation = (bool *) calloc(g->size + 1, sizeof(bool));
+  for(int i = 0; i < nslots; i++) {
+    component[i] = -1;
+  }
+  for(int v = 0; v < g->size; v++) {
+    disc[v] = -1;
+  }
+
+  for(int root = 0; root < g->size; root++) {
+    if(disc[root] != -1 || !containsVertex(g, root)) continue;
+
+    rootChildren = 0;
+    disc[root] = low[root] = time++;
+    setLowLinkFrame(&stack[nstack++], g, offset, root, -1, -1, 0);
+    while(nstack > 0) {
+      top = &stack[nstack - 1];
+      vertex = top->vertex;
+
+      if(top->next != NULL) {
+        adj = top->next;
+        slot = top->slot;
+        top->next = adj->next;
+        top->slot += 1;
+        STATS_ADD(edgesScanned, 1);
+        if(adj->edge == vertex) continue;
+
+        if(disc[adj->edge] == -1) {
+          edgeStack[nedgeStack++] = slot;
+          disc[adj->edge] = low[adj->edge] = time++;
+          setLowLinkFrame(&stack[nstack++], g, offset, adj->edge, vertex, slot, adj->weight);
+        } else if(adj->edge != top->parent && disc[adj->edge] < disc[vertex]) {
+          // Back edge to an ancestor, met from the descendant side first
+          edgeStack[nedgeStack++] = slot;
+          if(disc[adj->edge] < low[vertex]) low[vertex] = disc[adj->edge];
+        }
+        continue;
+      }
+
+      // All the edges of the vertex have been looked at: report to the parent
+      STATS_ADD(verticesSettled, 1);
+      parent = top->parent;
+      slot = top->treeSlot;
+      nstack -= 1;
+      if(parent == -1) continue;
+
+      if(low[vertex] < low[parent]) low[parent] = low[vertex];
+      if(low[vertex] >= disc[parent]) {
+        do {
+          component[edgeStack[--nedgeStack]] = b->ncomponents;
+        } while(edgeStack[nedgeStack] != slot);
+        b->ncomponents += 1;
+
+        if(parent != root) {
+          articulation[parent] = true;
+        } else {
+          rootChildren += 1;
+        }
+      }
+      if(low[vertex] > disc[parent]) {
+        b->bridges[b->nbridges].source = parent < vertex ? parent : vertex;
+        b->bridges[b->nbridges].destination = parent < vertex ? vertex : parent;
+        b->bridges[b->nbridges].weight = top->treeWeight;
+        b->nbridges += 1;
+      }
+    }
+    if(rootChildren >= 2) articulation[root] = true;
+  }
+
+  // Each edge has been pushed once, from the side that met it first
+  b->edges = (weightedEdge *) malloc(sizeof(weightedEdge) * (nslots / 2 + 1));
+  b->component = (int *) malloc(sizeof(int) * (nslots / 2 + 1));
+  for(int v = 0; v < g->size; v++) {
+    slot = offset[v];
+    for(adj = g->adjList[v]; adj != NULL; adj = adj->next, slot++) {
+      if(component[slot] == -1) continue;
+
+      b->edges[b->nedges].source = v < adj->edge ? v : adj->edge;
+      b->edges[b->nedges].destination = v < adj->edge ? adj->edge : v;
+      b->edges[b->nedges].weight = adj->weight;
+      b->component[b->nedges] = component[slot];
+      b->nedges += 1;
+    }
+  }
+  for(int v = 0; v < g->size; v++) {
+    if(articulation[v]) b->articulationPoints[b->narticulationPoints++] = v;
+  }
+
+  free(offset);
+  free(component);
+  free(edgeStack);
+  free(stack);
+  free(disc);
+  free(low);
+  free(articulation);
+  return b;
+}
+
+void destroyBiconnectedComponents(biconnectedComponents *b) {
+  free(b->edges);
+  free(b->component);
+  free(b->bridges);
+  free(b->articulationPoints);
+  free(b);
+}
+
+/* BICONNECTED COMPONENTS - END */
+
+
+/* MAXIMUM FLOW - START */
+
+flowNetwork * initializeFlowNetwork(graph *g) {
+  flowNetwork *f = NULL;
+  size_t *position = NULL;
+  size_t arc, reverse;
+
+  if(!g->directed) return NULL;
+
+  f = (flowNetwork *) malloc(sizeof(flowNetwork));
+  f->size = g->size;
+  f->source = -1;
+  f->sink = -1;
+  f->value = 0;
+  f->edges = getEdges(g, &f->nedges);
+  for(int i = 0; i < f->nedges; i++) {
+    if(f->edges[i].weight < 0) {
+      free(f->edges);
+      free(f);
+      return NULL;
+    }
+  }
+
+  // Each edge puts its forward arc among the arcs of the source and its reverse arc among the ones of the destination
+  f->offset = (size_t *) calloc(g->size + 1, sizeof(size_t));
+  for(int i = 0; i < f->nedges; i++) {
+    f->offset[f->edges[i].source + 1] += 1;
+    f->offset[f->edges[i].destination + 1] += 1;
+  }
+  for(int v = 0; v < g->size; v++) {
+    f->offset[v + 1] += f->offset[v];
+  }
+
+  f->head = (int *) malloc(sizeof(int) * (2 * f->nedges + 1));
+  f->twin = (int *) malloc(sizeof(int) * (2 * f->nedges + 1));
+  f->edge = (int *) malloc(sizeof(int) * (2 * f->nedges + 1));
+  f->capacity = (long long *) malloc(sizeof(long long) * (2 * f->nedges + 1));
+  f->flow = (long long *) calloc(2 * f->nedges + 1, sizeof(long long));
+  f->edgeArc = (int *) malloc(sizeof(int) * (f->nedges + 1));
+  position = (size_t *) malloc(sizeof(size_t) * (g->size + 1));
+  memcpy(position, f->offset, sizeof(size_t) * (g->size + 1));
+  for(int i = 0; i < f->nedges; i++) {
+    arc = position[f->edges[i].source]++;
+    reverse = position[f->edges[i].destination]++;
+    f->head[arc] = f->edges[i].destination;
+    f->head[reverse] = f->edges[i].source;
+    f->twin[arc] = (int) reverse;
+    f->twin[reverse] = (int) arc;
+    f->edge[arc] = i;
+    f->edge[reverse] = -1;
+    f->capacity[arc] = f->edges[i].weight;
+    f->capacity[reverse] = 0;
+    f->edgeArc[i] = (int) arc;
+  }
+  free(position);
+
+  f->level = (int *) malloc(sizeof(int) * (g->size + 1));
+  f->current = (size_t *) malloc(sizeof(size_t) * (g->size + 1));
+  f->queue = (int *) malloc(sizeof(int) * (g->size + 1));
+  f->path = (int *) malloc(sizeof(int) * (g->size + 1));
+
+  return f;
+}
+
+/**
+ * Computes the distance from the source of each vertex using only the arcs with residual capacity.
+ */
+static bool flowLevels(flowNetwork *f, int source, int sink) {
+  int head = 0;
+  int tail = 0;
+  int vertex;
+
+  for(int v = 0; v < f->size; v++) {
+    f->level[v] = -1;
+  }
+  f->level[source] = 0;
+  f->queue[tail++] = source;
+  while(head < tail) {
+    vertex = f->queue[head++];
+    for(size_t a = f->offset[vertex]; a < f->offset[vertex + 1]; a++) {
+      STATS_ADD(edgesScanned, 1);
+      if(f->level[f->head[a]] == -1 && f->capacity[a] > f->flow[a]) {
+        f->level[f->head[a]] = f->level[vertex] + 1;
+        f->queue[tail++] = f->head[a];
+      }
+    }
+  }
+
+  return f->level[sink] != -1;
+}
+
+/**
+ * Saturates the level graph without recursion: the path advances along arcs to the next level, retreats from the
+ * dead ends (current skips the arcs already tried) and restarts from the tail of the first arc saturated by an
+ * augmentation.
+ */
+static long long blockingFlow(flowNetwork *f, int source, int sink, long long limit) {
+  long long total = 0;
+  long long bottleneck;
+  int npath = 0;
+  int vertex = source;
+  int saturated;
+  size_t a;
+
+  for(int v = 0; v < f->size; v++) {
+    f->current[v] = f->offset[v];
+  }
+
+  while(total < limit) {
+    if(vertex == sink) {
+      bottleneck = limit - total;
+      for(int i = 0; i < npath; i++) {
+        if(f->capacity[f->path[i]] - f->flow[f->path[i]] < bottleneck) bottleneck = f->capacity[f->path[i]] - f->flow[f->path[i]];
+      }
+      saturated = -1;
+      for(int i = 0; i < npath; i++) {
+        f->flow[f->path[i]] += bottleneck;
+        f->flow[f->twin[f->path[i]]] -= bottleneck;
+        if(saturated == -1 && f->flow[f->path[i]] == f->capacity[f->path[i]]) saturated = i;
+      }
+      STATS_ADD(relaxations, 1);
+      total += bottleneck;
+      if(saturated == -1) break;
+
+      npath = saturated;
+      vertex = f->head[f->twin[f->path[saturated]]];
+      continue;
+    }
+
+    for(; f->current[vertex] < f->offset[vertex + 1]; f->current[vertex]++) {
+      a = f->current[vertex];
+      if(f->capacity[a] > f->flow[a] && f->level[f->head[a]] == f->level[vertex] + 1) break;
+    }
+    if(f->current[vertex] < f->offset[vertex + 1]) {
+      f->path[npath++] = (int) f->current[vertex];
+      vertex = f->head[f->current[vertex]];
+    } else {
+      f->level[vertex] = -1;
+      if(npath == 0) break;
+      vertex = f->head[f->twin[f->path[--npath]]];
+      f->current[vertex] += 1;
+    }
+  }
+
+  return total;
+}
+
+/**
+ * Sends up to limit units from source to sink along residual paths.
+ */
+static long long dinic(flowNetwork *f, int source, int sink, long long limit) {
+  long long total = 0;
+
+  while(total < limit && flowLevels(f, source, sink)) {
+    total += blockingFlow(f, source, sink, limit - total);
+  }
+
+  return total;
+}
+
+long long getMaxFlow(flowNetwork *f, int source, int sink) {
+  if(source < 0 || source >= f->size || sink < 0 || sink >= f->size || source == sink) return -1;
+
+  if(source != f->source || sink != f->sink) {
+    for(int a = 0; a < 2 * f->nedges; a++) {
+      f->flow[a] = 0;
+    }
+    f->source = source;
+    f->sink = sink;
+    f->value = 0;
+  }
+  f->value += dinic(f, source, sink, LLONG_MAX);
+
+  return f->value;
+}
+
+static int getForwardArc(flowNetwork *f, int source, int destination) {
+  if(source < 0 || source >= f->size) return -1;
+
+  for(size_t a = f->offset[source]; a < f->offset[source + 1]; a++) {
+    if(f->head[a] == destination && f->edge[a] != -1) return (int) a;
+  }
+
+  return -1;
+}
+
+bool setFlowCapacity(flowNetwork *f, int source, int destination, int capacity) {
+  int arc = getForwardArc(f, source, destination);
+  long long excess;
+
+  if(arc == -1 || capacity < 0) return false;
+
+  f->capacity[arc] = capacity;
+  f->edges[f->edge[arc]].weight = capacity;
+  if(f->flow[arc] <= capacity) return true;
+
+  /*
+   * The source of the edge is left with an excess and its destination with a deficit of the same amount: first the
+   * excess is rerouted to the destination, then what is left goes back to the source of the flow and is taken back
+   * from its sink (the source and the sink of the flow can be unbalanced).
+   */
+  excess = f->flow[arc] - capacity;
+  f->flow[arc] = capacity;
+  f->flow[f->twin[arc]] = -capacity;
+  if(source != destination) excess -= dinic(f, source, destination, excess);
+  if(excess > 0 && source != f->source && source != f->sink) dinic(f, source, f->source, excess);
+  if(excess > 0 && destination != f->sink && destination != f->source) dinic(f, f->sink, destination, excess);
+
+  f->value = 0;
+  for(size_t a = f->offset[f->source]; a < f->offset[f->source + 1]; a++) {
+    f->value += f->flow[a];
+  }
+
+  return true;
+}
+
+long long getEdgeFlow(flowNetwork *f, int source, int destination) {
+  int arc = getForwardArc(f, source, destination);
+
+  return arc == -1 ? -1 : f->flow[arc];
+}
+
+bool * getMinCut(flowNetwork *f) {
+  bool *sourceSide = NULL;
+
+  if(f->source == -1) return NULL;
+
+  flowLevels(f, f->source, f->sink);
+  sourceSide = (bool *) malloc(sizeof(bool) * (f->size + 1));
+  for(int v = 0; v < f->size; v++) {
+    sourceSide[v] = f->level[v] != -1;
+  }
+
+  return sourceSide;
+}
+
+void destroyFlowNetwork(flowNetwork *f) {
+  free(f->offset);
+  free(f->head);
+  free(f->twin);
+  free(f->edge);
+  free(f->capacity);
+  free(f->flow);
+  free(f->edges);
+  free(f->edgeArc);
+  free(f->level);
+  free(f->current);
+  free(f->queue);
+  free(f->path);
+  free(f);
+}
+
+/* MAXIMUM FLOW - END */
+
+
+/* MINUMUM SPANNING TREE - START */
+
+graph * getPrimMST(graph *g) {
+  int ntrees;
+  graph *mst = getPrimMSF(g, &ntrees);
+
+  if(mst != NULL && ntrees != 1) {
+    destroyGraph(mst);
+    return NULL;
+  }
+
+  return mst;
+}
+
+/**
+ * Every vertex still white when the outer loop reaches it is the root of a new tree (the tombstones are not vertices).
+ * The heap has no decrease-key, so the stale entries of an already black vertex are skipped.
+ */
+graph * getPrimMSF(graph *g, int *ntrees) {
+  if(ntrees != NULL) *ntrees = 0;
+  if(g->directed) return NULL;
+
+  graph *mst = initializeGraph(false);
+  visitInfo *visit = initializeVisit(g);
+  heap *h = initializeHeap(g->size);
+  edgenode *adj = NULL;
+  int vertex;
+
+  addVertex(mst, g->size);
+
+  for(int root = 0; root < g->size; root++) {
+    if(visit->color[root] != WHITE || !containsVertex(g, root)) continue;
+
+    if(ntrees != NULL) *ntrees += 1;
+    visit->distance[root] = 0;
+    heapPush(h, root, 0);
+    while(h->size > 0) {
+      vertex = heapPop(h, NULL);
+      if(visit->color[vertex] == BLACK) continue;
+
+      STATS_ADD(verticesSettled, 1);
+      if(visit->parent[vertex] != -1) {
+        addEdgeWeight(mst, visit->parent[vertex], vertex, visit->distance[vertex]);
+      }
+      visit->color[vertex] = BLACK;
+      adj = getAdjacent(g, vertex);
+      while(adj != NULL) {
+        STATS_ADD(edgesScanned, 1);
+        if(visit->color[adj->edge] != BLACK && visit->distance[adj->edge] > adj->weight) {
+          STATS_ADD(relaxations, 1);
+          visit->color[adj->edge] = GRAY;
+          visit->parent[adj->edge] = vertex;
+          visit->distance[adj->edge] = adj->weight;
+          heapPush(h, adj->edge, adj->weight);
+        }
+        adj = adj->next;
+      }
+    }
+  }
+  destroyHeap(h);
+  destroyVisit(visit);
+
+  return mst;
+}
+
+graph * getKruskalMST(graph *g) {
+  int ntrees;
+  graph *mst = getKruskalMSF(g, &ntrees);
+
+  if(mst != NULL && ntrees != 1) {
+    destroyGraph(mst);
+    return NULL;
+  }
+
+  return mst;
+}
+
+graph * getKruskalMSF(graph *g, int *ntrees) {
+  if(ntrees != NULL) *ntrees = 0;
+  if(g->directed) return NULL;
+
+  graph *mst = initializeGraph(false);
+  k_union_find *kunion = initializeKUnionFind(g->size);
+  int nedges;
+  weightedEdge *edges = getEdges(g, &nedges);
+  int count = 0;
+
+  sortEdgesByWeight(edges, nedges);
+
+  addVertex(mst, g->size);
+
+  for(int i = 0; i < nedges && count < countVertices(g) - 1; i++) {
+    if(k_find(kunion, edges[i].source) != k_find(kunion, edges[i].destination)) {
+      k_union(kunion, edges[i].source, edges[i].destination);
+      addEdgeWeight(mst, edges[i].source, edges[i].destination, edges[i].weight);
+      count += 1;
+    }
+  }
+
+  if(ntrees != NULL) *ntrees = countVertices(g) - count;
+
+  free(edges);
+  destroyKUnionFind(kunion);
+  return mst;
+}
+
+#define FILTER_KRUSKAL_THRESHOLD 1024
+
+/**
+ * Base case of the Filter-Kruskal algorithm: sorts the edges and adds them to the tree while they join two different trees.
+ */
+static void kruskalScan(weightedEdge *edges, int nedges, bool sort, k_union_find *kunion, graph *mst, int *count) {
+  if(sort) {
+    sortEdgesByWeight(edges, nedges);
+  }
+
+  for(int i = 0; i < nedges && *count < mst->size-1; i++) {
+    if(k_find(kunion, edges[i].source) != k_find(kunion, edges[i].destination)) {
+      k_union(kunion, edges[i].source, edges[i].destination);
+      addEdgeWeight(mst, edges[i].source, edges[i].destination, edges[i].weight);
+      *count += 1;
+    }
+  }
+}
+
+static int medianWeight(weightedEdge *edges, int nedges) {
+  int a = edges[0].weight;
+  int b = edges[nedges/2].weight;
+  int c = edges[nedges-1].weight;
+
+  if((a <= b && b <= c) || (c <= b && b <= a)) return b;
+  if((b <= a && a <= c) || (c <= a && a <= b)) return a;
+  return c;
+}
+
+typedef struct filterKruskalRange filterKruskalRange;
+
+/**
+ * A range of edges waiting to be solved: filter tells if the edges joining the same tree must be dropped first,
+ * sorted if the edges all have the same weight.
+ */
+struct filterKruskalRange {
+  int start;
+  int nedges;
+  bool filter;
+  bool sorted;
+};
+
+static void pushFilterKruskalRange(filterKruskalRange **stack, int *top, int *capacity, int start, int nedges, bool filter, bool sorted) {
+  if(nedges == 0) return;
+  if(*top == *capacity) {
+    *capacity *= 2;
+    *stack = (filterKruskalRange *) realloc(*stack, sizeof(filterKruskalRange) * *capacity);
+  }
+  (*stack)[*top].start = start;
+  (*stack)[*top].nedges = nedges;
+  (*stack)[*top].filter = filter;
+  (*stack)[*top].sorted = sorted;
+  *top += 1;
+}
+
+/**
+ * The edges are split in three parts: [0, light) with weight < pivot, [light, heavy) with weight == pivot
+ * and [heavy, nedges) with weight > pivot. The light part is solved first, the equal part doesn't need
+ * to be sorted, the heavy part is filtered and solved last. The ranges are kept on an explicit stack, pushed
+ * from the heaviest to the lightest, so that the depth doesn't depend on how the pivots split the edges.
+ */
+static void filterKruskal(weightedEdge *edges, int nedges, k_union_find *kunion, graph *mst, int *count) {
+  int capacity = 16;
+  filterKruskalRange *stack = (filterKruskalRange *) malloc(sizeof(filterKruskalRange) * capacity);
+  filterKruskalRange range;
+  weightedEdge *part;
+  weightedEdge temp;
+  int top = 0;
+  int pivot;
+  int light;
+  int heavy;
+  int i;
+  int j;
+
+  pushFilterKruskalRange(&stack, &top, &capacity, 0, nedges, false, false);
+  while(top > 0 && *count < mst->size-1) {
+    range = stack[--top];
+    part = edges + range.start;
+
+    if(range.filter) {
+      j = 0;
+      for(i = 0; i < range.nedges; i++) {
+        if(k_find(kunion, part[i].source) != k_find(kunion, part[i].destination)) {
+          part[j++] = part[i];
+        }
+      }
+      range.nedges = j;
+    }
+
+    if(range.sorted || range.nedges <= FILTER_KRUSKAL_THRESHOLD) {
+      kruskalScan(part, range.nedges, !range.sorted, kunion, mst, count);
+      continue;
+    }
+
+    pivot = medianWeight(part, range.nedges);
+    light = 0;
+    heavy = range.nedges;
+    i = 0;
+    while(i < heavy) {
+      if(part[i].weight < pivot) {
+        temp = part[i];
+        part[i++] = part[light];
+        part[light++] = temp;
+      } else if(part[i].weight > pivot) {
+        temp = part[i];
+        part[i] = part[--heavy];
+        part[heavy] = temp;
+      } else {
+        i++;
+      }
+    }
+
+    pushFilterKruskalRange(&stack, &top, &capacity, range.start + heavy, range.nedges - heavy, true, false);
+    pushFilterKruskalRange(&stack, &top, &capacity, range.start + light, heavy - light, false, true);
+    pushFilterKruskalRange(&stack, &top, &capacity, range.start, light, false, false);
+  }
+
+  free(stack);
+}
+
+graph * getFilterKruskalMST(graph *g) {
+  if(!isConnected(g)) return NULL;
+
+  graph *mst = initializeGraph(false);
+  k_union_find *kunion = initializeKUnionFind(g->size);
+  int nedges;
+  weightedEdge *edges = getEdges(g, &nedges);
+  int count = 0;
+
+  addVertex(mst, g->size);
+  filterKruskal(edges, nedges, kunion, mst, &count);
+
+  free(edges);
+  destroyKUnionFind(kunion);
+  return mst;
+}
+
+#define BORUVKA_NO_EDGE ULLONG_MAX
+
+typedef struct boruvkaTask boruvkaTask;
+
+struct boruvkaTask {
+  weightedEdge *edges;
+  int nedges;
+  int *component;
+  atomic_ullong *best;
+  bool *selected;
+  c_union_find *cunion;
+};
+
+static void boruvkaComponentChunk(int start, int end, void *arg) {
+  boruvkaTask *task = (boruvkaTask *) arg;
+
+  for(int v = start; v < end; v++) {
+    task->component[v] = c_find(task->cunion, v);
+    atomic_store_explicit(&task->best[v], BORUVKA_NO_EDGE, memory_order_relaxed);
+  }
+}
+
+static void boruvkaAtomicMin(atomic_ullong *best, unsigned long long key) {
+  unsigned long long current = atomic_load_explicit(best, memory_order_relaxed);
+
+  while(key < current && !atomic_compare_exchange_weak(best, &current, key));
+}
+
+/**
+ * The key of an edge is its weight followed by its index, so the minimum is unique and no cycle can be selected.
+ */
+static void boruvkaSelectChunk(int start, int end, void *arg) {
+  boruvkaTask *task = (boruvkaTask *) arg;
+  unsigned long long key;
+  int a;
+  int b;
+
+  for(int i = start; i < end; i++) {
+    a = task->component[task->edges[i].source];
+    b = task->component[task->edges[i].destination];
+    if(a != b) {
+      key = ((unsigned long long) (((unsigned int) task->edges[i].weight) ^ 0x80000000u) << 32) | (unsigned int) i;
+      boruvkaAtomicMin(&task->best[a], key);
+      boruvkaAtomicMin(&task->best[b], key);
+    }
+  }
+}
+
+static void boruvkaMergeChunk(int start, int end, void *arg) {
+  boruvkaTask *task = (boruvkaTask *) arg;
+  unsigned long long key;
+  int i;
+
+  for(int c = start; c < end; c++) {
+    key = atomic_load_explicit(&task->best[c], memory_order_relaxed);
+    if(task->component[c] != c || key == BORUVKA_NO_EDGE) continue;
+
+    i = (int) (key & 0xFFFFFFFFu);
+    if(c_union(task->cunion, task->edges[i].source, task->edges[i].destination)) {
+      task->selected[i] = true;
+    }
+  }
+}
+
+graph * getBoruvkaMST(graph *g) {
+  if(g->directed) return NULL;
+
+  graph *mst = initializeGraph(false);
+  boruvkaTask task;
+  bool merged = true;
+  int j;
+
+  task.edges = getEdges(g, &task.nedges);
+  task.component = (int *) malloc(sizeof(int) * (g->size + 1));
+  task.best = (atomic_ullong *) malloc(sizeof(atomic_ullong) * (g->size + 1));
+  task.selected = (bool *) calloc(task.nedges + 1, sizeof(bool));
+  task.cunion = initializeCUnionFind(g->size);
+
+  addVertex(mst, g->size);
+
+  while(merged && task.nedges > 0) {
+    parallelFor(0, g->size, boruvkaComponentChunk, &task);
+    parallelFor(0, task.nedges, boruvkaSelectChunk, &task);
+    parallelFor(0, g->size, boruvkaMergeChunk, &task);
+
+    merged = false;
+    j = 0;
+    for(int i = 0; i < task.nedges; i++) {
+      if(task.selected[i]) {
+        addEdgeWeight(mst, task.edges[i].source, task.edges[i].destination, task.edges[i].weight);
+        task.selected[i] = false;
+        merged = true;
+      } else if(c_find(task.cunion, task.edges[i].source) != c_find(task.cunion, task.edges[i].destination)) {
+        task.edges[j++] = task.edges[i];
+      }
+    }
+    task.nedges = j;
+  }
+
+  free(task.edges);
+  free(task.component);
+  free(task.best);
+  free(task.selected);
+  destroyCUnionFind(task.cunion);
+  return mst;
+}
+
+/* MINUMUM SPANNING TREE - END */
+
+
+/* VERTEX REORDERING - START */
+
+static int compareByDegree(const void *a, const void *b) {
+  const int *aa = (const int *) a;
+  const int *bb = (const int *) b;
+
+  return (aa[1] > bb[1]) - (aa[1] < bb[1]);
+}
+
+/**
+ * Vertices sorted by degree with a counting sort (ascending if ascending is true, descending otherwise).
+ */
+static void sortVerticesByDegree(int *degree, int size, bool ascending, int *sorted) {
+  int maxDegree = 0;
+  int *count = NULL;
+
+  for(int v = 0; v < size; v++) {
+    if(degree[v] > maxDegree) maxDegree = degree[v];
+  }
+  count = (int *) calloc(maxDegree + 2, sizeof(int));
+  for(int v = 0; v < size; v++) {
+    count[ascending ? degree[v] + 1 : maxDegree - degree[v] + 1] += 1;
+  }
+  for(int d = 1; d <= maxDegree + 1; d++) {
+    count[d] += count[d-1];
+  }
+  for(int v = 0; v < size; v++) {
+    sorted[count[ascending ? degree[v] : maxDegree - degree[v]]++] = v;
+  }
+  free(count);
+}
+
+/**
+ * BFS of all the components: the roots are taken in the order of roots. With byDegree the neighbours of
+ * each vertex are visited by increasing degree (Cuthill-McKee), otherwise in adjacency list order.
+ */
+static void orderByBFS(graph *g, int *degree, int *roots, bool byDegree, int *order) {
+  bool *visited = (bool *) calloc(g->size + 1, sizeof(bool));
+  int (*neighbours)[2] = NULL;
+  edgenode *adj = NULL;
+  int head = 0;
+  int tail = 0;
+  int n;
+
+  if(byDegree) {
+    neighbours = (int (*)[2]) malloc(sizeof(int[2]) * (g->size + 1));
+  }
+
+  for(int r = 0; r < g->size; r++) {
+    if(visited[roots[r]]) continue;
+
+    visited[roots[r]] = true;
+    order[tail++] = roots[r];
+    while(head < tail) {
+      n = 0;
+      for(adj = g->adjList[order[head++]]; adj != NULL; adj = adj->next) {
+        if(visited[adj->edge]) continue;
+
+        visited[adj->edge] = true;
+        if(byDegree) {
+          neighbours[n][0] = adj->edge;
+          neighbours[n++][1] = degree[adj->edge];
+        } else {
+          order[tail++] = adj->edge;
+        }
+      }
+      if(byDegree) {
+        qsort(neighbours, n, sizeof(neighbours[0]), compareByDegree);
+        for(int i = 0; i < n; i++) {
+          order[tail++] = neighbours[i][0];
+        }
+      }
+    }
+  }
+
+  free(neighbours);
+  free(visited);
+}
+
+vertexMap * getVertexOrdering(graph *g, enum vertexOrdering ordering) {
+  vertexMap *map = (vertexMap *) malloc(sizeof(vertexMap));
+  int *degree = (int *) calloc(g->size + 1, sizeof(int));
+  int *roots = NULL;
+  int temp;
+
+  map->size = g->size;
+  map->newId = (int *) malloc(sizeof(int) * (g->size + 1));
+  map->oldId = (int *) malloc(sizeof(int) * (g->size + 1));
+
+  for(int v = 0; v < g->size; v++) {
+    for(edgenode *adj = g->adjList[v]; adj != NULL; adj = adj->next) {
+      degree[v] += 1;
+    }
+  }
+
+  if(ordering == DEGREE_ORDER) {
+    sortVerticesByDegree(degree, g->size, false, map->oldId);
+  } else if(ordering == BFS_ORDER) {
+    roots = (int *) malloc(sizeof(int) * (g->size + 1));
+    for(int v = 0; v < g->size; v++) {
+      roots[v] = v;
+    }
+    orderByBFS(g, degree, roots, false, map->oldId);
+  } else {
+    roots = (int *) malloc(sizeof(int) * (g->size + 1));
+    sortVerticesByDegree(degree, g->size, true, roots);
+    orderByBFS(g, degree, roots, true, map->oldId);
+    for(int i = 0; i < g->size / 2; i++) {
+      temp = map->oldId[i];
+      map->oldId[i] = map->oldId[g->size - 1 - i];
+      map->oldId[g->size - 1 - i] = temp;
+    }
+  }
+
+  for(int i = 0; i < g->size; i++) {
+    map->newId[map->oldId[i]] = i;
+  }
+
+  free(roots);
+  free(degree);
+  return map;
+}
+
+vertexMap * reorderGraph(graph *g, enum vertexOrdering ordering) {
+  vertexMap *map = getVertexOrdering(g, ordering);
+  edgenode **adjList = (edgenode **) malloc(sizeof(edgenode *) * (g->size + 1));
+  edgenode **last = NULL;
+  edgenode *node = NULL;
+  bool *removed = NULL;
+
+  for(int i = 0; i < g->size; i++) {
+    last = &adjList[i];
+    for(edgenode *adj = g->adjList[map->oldId[i]]; adj != NULL; adj = adj->next) {
+      node = (edgenode *) malloc(sizeof(edgenode));
+      node->edge = map->newId[adj->edge];
+      node->weight = adj->weight;
+      *last = node;
+      last = &node->next;
+    }
+    *last = NULL;
+    destroyAdjList(g->adjList[map->oldId[i]]);
+  }
+  free(g->adjList);
+  g->adjList = adjList;
+
+  if(g->removed != NULL) {
+    removed = (bool *) malloc(sizeof(bool) * (g->size + 1));
+    for(int i = 0; i < g->size; i++) {
+      removed[i] = g->removed[map->oldId[i]];
+    }
+    free(g->removed);
+    g->removed = removed;
+  }
+
+  if(g->inAdjList != NULL) {
+    disableReverseIndex(g);
+    enableReverseIndex(g);
+  }
+
+  if(g->connectivity != NULL) {
+    connectivityRebuild(g);
+  }
+
+  return map;
+}
+
+visitInfo * translateVisit(visitInfo *visit, vertexMap *map) {
+  visitInfo *translated = (visitInfo *) malloc(sizeof(visitInfo));
+  int v;
+
+  translated->startTime = (int *) malloc(sizeof(int) * (map->size + 1));
+  translated->endTime = (int *) malloc(sizeof(int) * (map->size + 1));
+  translated->parent = (int *) malloc(sizeof(int) * (map->size + 1));
+  translated->distance = (int *) malloc(sizeof(int) * (map->size + 1));
+  translated->color = (enum color *) malloc(sizeof(enum color) * (map->size + 1));
+
+  for(int old = 0; old < map->size; old++) {
+    v = map->newId[old];
+    translated->startTime[old] = visit->startTime[v];
+    translated->endTime[old] = visit->endTime[v];
+    translated->parent[old] = visit->parent[v] == -1 ? -1 : map->oldId[visit->parent[v]];
+    translated->distance[old] = visit->distance[v];
+    translated->color[old] = visit->color[v];
+  }
+
+  return translated;
+}
+
+void destroyVertexMap(vertexMap *map) {
+  free(map->newId);
+  free(map->oldId);
+  free(map);
+}
+
+/* VERTEX REORDERING - END */
+
+
+/* COMPRESSED GRAPH - START */
+
+static int compareNeighbours(const void *a, const void *b) {
+  const int *x = (const int *) a;
+  const int *y = (const int *) b;
+
+  if(x[0] != y[0]) return (x[0] > y[0]) - (x[0] < y[0]);
+  return (x[1] > y[1]) - (x[1] < y[1]);
+}
+
+static void appendVarint(unsigned char **data, size_t *length, size_t *capacity, unsigned int value) {
+  if(*length + 5 > *capacity) {
+    *capacity = *capacity * 2 + 5;
+    *data = (unsigned char *) realloc(*data, *capacity);
+  }
+
+  while(value >= 0x80) {
+    (*data)[(*length)++] = (unsigned char) (value & 0x7F) | 0x80;
+    value >>= 7;
+  }
+  (*data)[(*length)++] = (unsigned char) value;
+}
+
+compressedGraph * compressGraph(graph *g) {
+  compressedGraph *c = (compressedGraph *) malloc(sizeof(compressedGraph));
+  size_t nedges = 0;
+  size_t length = 0;
+  size_t capacity = 0;
+  int maxDegree = 0;
+  int degree;
+  bool weighted = false;
+  edgenode *adj = NULL;
+
+  c->size = g->size;
+  c->directed = g->directed;
+  c->data = NULL;
+  c->dataOffset = (size_t *) malloc(sizeof(size_t) * (g->size + 1));
+  c->edgeOffset = (size_t *) malloc(sizeof(size_t) * (g->size + 1));
+
+  for(int v = 0; v < g->size; v++) {
+    degree = 0;
+    for(adj = g->adjList[v]; adj != NULL; adj = adj->next) {
+      weighted = weighted || adj->weight != DEFAULT_EDGE_WEIGHT;
+      degree += 1;
+    }
+    c->edgeOffset[v] = nedges;
+    nedges += degree;
+    if(degree > maxDegree) maxDegree = degree;
+  }
+  c->edgeOffset[g->size] = nedges;
+  c->weights = weighted ? (int *) malloc(sizeof(int) * (nedges > 0 ? nedges : 1)) : NULL;
+
+  /* pairs of (neighbour, weight) of the current vertex, sorted by neighbour */
+  int (*neighbours)[2] = malloc(sizeof(int[2]) * (maxDegree > 0 ? maxDegree : 1));
+
+  for(int v = 0; v < g->size; v++) {
+    degree = 0;
+    for(adj = g->adjList[v]; adj != NULL; adj = adj->next) {
+      neighbours[degree][0] = adj->edge;
+      neighbours[degree][1] = adj->weight;
+      degree += 1;
+    }
+    qsort(neighbours, degree, sizeof(neighbours[0]), compareNeighbours);
+
+    c->dataOffset[v] = length;
+    for(int i = 0; i < degree; i++) {
+      if(i == 0) {
+        /* zigzag: the first neighbour can be smaller than the vertex */
+        int delta = neighbours[0][0] - v;
+        appendVarint(&c->data, &length, &capacity, ((unsigned int) delta << 1) ^ (unsigned int) -(delta < 0));
+      } else {
+        appendVarint(&c->data, &length, &capacity, (unsigned int) (neighbours[i][0] - neighbours[i-1][0]));
+      }
+      if(weighted) c->weights[c->edgeOffset[v] + i] = neighbours[i][1];
+    }
+  }
+  c->dataOffset[g->size] = length;
+
+  free(neighbours);
+  c->data = (unsigned char *) realloc(c->data, length > 0 ? length : 1);
+  return c;
+}
+
+size_t getCompressedGraphBytes(compressedGraph *c) {
+  size_t bytes = sizeof(compressedGraph) + c->dataOffset[c->size];
+
+  bytes += sizeof(size_t) * (c->size + 1) * 2;
+  if(c->weights != NULL) bytes += sizeof(int) * c->edgeOffset[c->size];
+  return bytes;
+}
+
+void destroyCompressedGraph(compressedGraph *c) {
+  free(c->data);
+  free(c->dataOffset);
+  free(c->edgeOffset);
+  free(c->weights);
+  free(c);
+}
+
+/* COMPRESSED GRAPH - END */
+
+
+/* NEIGHBOUR ITERATION - START */
+
+csrGraph * getCSRGraph(graph *g) {
+  csrGraph *c = (csrGraph *) malloc(sizeof(csrGraph));
+  edgenode *adj = NULL;
+  size_t nedges = 0;
+
+  c->size = g->size;
+  c->directed = g->directed;
+  c->offset = (size_t *) malloc(sizeof(size_t) * (g->size + 1));
+  for(int v = 0; v < g->size; v++) {
+    c->offset[v] = nedges;
+    for(adj = g->adjList[v]; adj != NULL; adj = adj->next) {
+      nedges += 1;
+    }
+  }
+  c->offset[g->size] = nedges;
+
+  c->target = (int *) malloc(sizeof(int) * (nedges > 0 ? nedges : 1));
+  c->weight = (int *) malloc(sizeof(int) * (nedges > 0 ? nedges : 1));
+  nedges = 0;
+  for(int v = 0; v < g->size; v++) {
+    for(adj = g->adjList[v]; adj != NULL; adj = adj->next) {
+      c->target[nedges] = adj->edge;
+      c->weight[nedges] = adj->weight;
+      nedges += 1;
+    }
+  }
+
+  return c;
+}
+
+void destroyCSRGraph(csrGraph *c) {
+  free(c->offset);
+  free(c->target);
+  free(c->weight);
+  free(c);
+}
+
+static inline bool containsCSRVertex(csrGraph *c, int vertex) {
+  return vertex >= 0 && vertex < c->size;
+}
+
+static inline bool containsCompressedVertex(compressedGraph *c, int vertex) {
+  return vertex >= 0 && vertex < c->size;
+}
+
+/**
+ * The algorithms are written once over begin/next and instantiated for every storage, so the compiler inlines the
+ * iterator of each storage in its own copy. GRAPH must have the size and directed fields, CONTAINS checks a vertex.
+ *
+ * The DFS replaces the recursion of getDFSImpl with a stack of iterators: a vertex is finished when its iterator is
+ * exhausted, so the times are the same of the recursive visit.
+ */
+#define DEFINE_NEIGHBOUR_ALGORITHMS(NAME, GRAPH, ITERATOR, CONTAINS, BEGIN, NEXT) \
+visitInfo * get##NAME##BFS(GRAPH *g, int startingVertex) { \
+  if(!CONTAINS(g, startingVertex)) return NULL; \
+  \
+  STATS_PHASE_START(STATS_INITIALIZATION); \
+  visitInfo *visit = initializeVisitSize(g->size); \
+  int *queue = (int *) malloc(sizeof(int) * g->size); \
+  STATS_ALLOC(sizeof(int) * g->size); \
+  ITERATOR it; \
+  int head = 0; \
+  int tail = 0; \
+  int vertex; \
+  int neighbour; \
+  int weight; \
+  int time = 0; \
+  STATS_PHASE_END(STATS_INITIALIZATION); \
+  \
+  STATS_PHASE_START(STATS_SEARCH); \
+  visit->distance[startingVertex] = 0; \
+  visit->color[startingVertex] = GRAY; \
+  queue[tail++] = startingVertex; \
+  while(head < tail) { \
+    vertex = queue[head++]; \
+    STATS_ADD(verticesSettled, 1); \
+    visit->startTime[vertex] = time++; \
+    BEGIN(g, vertex, &it); \
+    while(NEXT(&it, &neighbour, &weight)) { \
+      STATS_ADD(edgesScanned, 1); \
+      if(visit->color[neighbour] == WHITE) { \
+        visit->color[neighbour] = GRAY; \
+        visit->parent[neighbour] = vertex; \
+        visit->distance[neighbour] = visit->distance[vertex] + 1; \
+        queue[tail++] = neighbour; \
+      } \
+    } \
+    visit->color[vertex] = BLACK; \
+    visit->endTime[vertex] = time++; \
+  } \
+  free(queue); \
+  STATS_PHASE_END(STATS_SEARCH); \
+  \
+  return visit; \
+} \
+\
+visitInfo * get##NAME##DFS(GRAPH *g, int startingVertex) { \
+  if(!CONTAINS(g, startingVertex)) return NULL; \
+  \
+  STATS_PHASE_START(STATS_INITIALIZATION); \
+  visitInfo *visit = initializeVisitSize(g->size); \
+  ITERATOR *stack = (ITERATOR *) malloc(sizeof(ITERATOR) * g->size); \
+  int *vertices = (int *) malloc(sizeof(int) * g->size); \
+  STATS_ALLOC((sizeof(ITERATOR) + sizeof(int)) * g->size); \
+  int top = 0; \
+  int vertex; \
+  int neighbour; \
+  int weight; \
+  int time = 0; \
+  STATS_PHASE_END(STATS_INITIALIZATION); \
+  \
+  STATS_PHASE_START(STATS_SEARCH); \
+  visit->color[startingVertex] = GRAY; \
+  visit->startTime[startingVertex] = time++; \
+  vertices[top] = startingVertex; \
+  BEGIN(g, startingVertex, &stack[top++]); \
+  while(top > 0) { \
+    vertex = vertices[top-1]; \
+    if(NEXT(&stack[top-1], &neighbour, &weight)) { \
+      STATS_ADD(edgesScanned, 1); \
+      if(visit->color[neighbour] == WHITE) { \
+        visit->parent[neighbour] = vertex; \
+        visit->color[neighbour] = GRAY; \
+        visit->startTime[neighbour] = time++; \
+        vertices[top] = neighbour; \
+        BEGIN(g, neighbour, &stack[top++]); \
+      } \
+    } else { \
+      STATS_ADD(verticesSettled, 1); \
+      visit->color[vertex] = BLACK; \
+      visit->endTime[vertex] = time++; \
+      top -= 1; \
+    } \
+  } \
+  free(stack); \
+  free(vertices); \
+  STATS_PHASE_END(STATS_SEARCH); \
+  \
+  return visit; \
+} \
+\
+visitInfo * get##NAME##DijkstraShortestPaths(GRAPH *g, int startingVertex) { \
+  if(!CONTAINS(g, startingVertex)) return NULL; \
+  \
+  STATS_PHASE_START(STATS_INITIALIZATION); \
+  visitInfo *visit = initializeVisitSize(g->size); \
+  heap *h = initializeHeap(16); \
+  ITERATOR it; \
+  int vertex; \
+  int neighbour; \
+  int weight; \
+  STATS_PHASE_END(STATS_INITIALIZATION); \
+  \
+  STATS_PHASE_START(STATS_SEARCH); \
+  visit->distance[startingVertex] = 0; \
+  heapPush(h, startingVertex, 0); \
+  while(h->size > 0) { \
+    vertex = heapPop(h, NULL); \
+    if(visit->color[vertex] == BLACK) continue; \
+    visit->color[vertex] = BLACK; \
+    STATS_ADD(verticesSettled, 1); \
+    BEGIN(g, vertex, &it); \
+    while(NEXT(&it, &neighbour, &weight)) { \
+      STATS_ADD(edgesScanned, 1); \
+      if(weight < 0) { \
+        destroyHeap(h); \
+        destroyVisit(visit); \
+        STATS_PHASE_END(STATS_SEARCH); \
+        return NULL; \
+      } \
+      \
+      if(visit->distance[neighbour] > visit->distance[vertex] + weight) { \
+        STATS_ADD(relaxations, 1); \
+        visit->parent[neighbour] = vertex; \
+        visit->distance[neighbour] = visit->distance[vertex] + weight; \
+        heapPush(h, neighbour, visit->distance[neighbour]); \
+      } \
+    } \
+  } \
+  destroyHeap(h); \
+  STATS_PHASE_END(STATS_SEARCH); \
+  \
+  return visit; \
+} \
+\
+lists * get##NAME##ConnectedComponents(GRAPH *g) { \
+  if(g->directed) return NULL; \
+  \
+  lists *connectedComponents = initializeLists(); \
+  int *component = (int *) malloc(sizeof(int) * g->size); \
+  int *queue = (int *) malloc(sizeof(int) * g->size); \
+  ITERATOR it; \
+  int head; \
+  int tail; \
+  int vertex; \
+  int neighbour; \
+  int weight; \
+  \
+  for(int v = 0; v < g->size; v++) { \
+    component[v] = -1; \
+  } \
+  \
+  for(int v = 0; v < g->size; v++) { \
+    if(component[v] != -1 || !CONTAINS(g, v)) continue; \
+    \
+    component[v] = connectedComponents->size; \
+    addList(connectedComponents, NULL); \
+    head = 0; \
+    tail = 0; \
+    queue[tail++] = v; \
+    while(head < tail) { \
+      vertex = queue[head++]; \
+      BEGIN(g, vertex, &it); \
+      while(NEXT(&it, &neighbour, &weight)) { \
+        if(component[neighbour] == -1) { \
+          component[neighbour] = component[v]; \
+          queue[tail++] = neighbour; \
+        } \
+      } \
+    } \
+  } \
+  \
+  for(int v = 0; v < g->size; v++) { \
+    if(component[v] != -1) addNode(connectedComponents, v, component[v]); \
+  } \
+  \
+  free(component); \
+  free(queue); \
+  return connectedComponents; \
+}
+
+DEFINE_NEIGHBOUR_ALGORITHMS(List, graph, listIterator, containsVertex, listBegin, listNext)
+DEFINE_NEIGHBOUR_ALGORITHMS(CSR, csrGraph, csrIterator, containsCSRVertex, csrBegin, csrNext)
+DEFINE_NEIGHBOUR_ALGORITHMS(Compressed, compressedGraph, compressedIterator, containsCompressedVertex, compressedBegin, compressedNext)
+
+/* NEIGHBOUR ITERATION - END */
+
+
+/* CONCURRENT SNAPSHOTS - START */
+
+static graphSnapshot * newSnapshot(graph *g, long version) {
+  graphSnapshot *snapshot = (graphSnapshot *) malloc(sizeof(graphSnapshot));
+
+  snapshot->g.adjList = (edgenode **) malloc(sizeof(edgenode *) * (g->size + 1));
+  memcpy(snapshot->g.adjList, g->adjList, sizeof(edgenode *) * g->size);
+  snapshot->g.size = g->size;
+  snapshot->g.directed = g->directed;
+  snapshot->g.lazyRemoval = g->lazyRemoval;
+  snapshot->g.removed = NULL;
+  snapshot->g.removedCount = g->removedCount;
+  if(g->removed != NULL) {
+    // The flags are copied: addVertex can move the array of the writers
+    snapshot->g.removed = (bool *) malloc(sizeof(bool) * g->size);
+    memcpy(snapshot->g.removed, g->removed, sizeof(bool) * g->size);
+  }
+  snapshot->g.connectivity = NULL;
+  snapshot->g.inAdjList = NULL;
+  snapshot->g.view = true;
+  snapshot->version = version;
+  snapshot->readers = 0;
+  snapshot->retired = NULL;
+  snapshot->nretired = 0;
+  snapshot->newer = NULL;
+
+  return snapshot;
+}
+
+static void freeSnapshot(graphSnapshot *snapshot) {
+  for(int i = 0; i < snapshot->nretired; i++) {
+    free(snapshot->retired[i]);
+  }
+  free(snapshot->retired);
+  free(snapshot->g.removed);
+  free(snapshot->g.adjList);
+  free(snapshot);
+}
+
+/**
+ * The retired nodes of a snapshot can be in the older snapshots too, so the snapshots are freed from the oldest one.
+ * It is called with the snapshot lock held.
+ */
+static void reclaimSnapshots(concurrentGraph *cg) {
+  graphSnapshot *snapshot = NULL;
+
+  while(cg->oldest != cg->current && cg->oldest->readers == 0) {
+    snapshot = cg->oldest;
+    cg->oldest = snapshot->newer;
+    freeSnapshot(snapshot);
+  }
+}
+
+static void retireNode(concurrentGraph *cg, edgenode *node) {
+  if(cg->npending == cg->pendingCapacity) {
+    cg->pendingCapacity = cg->pendingCapacity * 2 + 16;
+    cg->pending = (edgenode **) realloc(cg->pending, sizeof(edgenode *) * cg->pendingCapacity);
+  }
+  cg->pending[cg->npending++] = node;
+}
+
+/**
+ * The nodes before the edge are copied (they can be in a published snapshot), then the edge is removed or
+ * replaced by a copy with the new weight. The nodes after the edge are shared.
+ */
+static void copyOnWrite(concurrentGraph *cg, int vertex, int target, bool remove, int weight) {
+  edgenode **link = &cg->g->adjList[vertex];
+  edgenode *node = NULL;
+  edgenode *copy = NULL;
+
+  while((*link)->edge != target) {
+    node = *link;
+    copy = (edgenode *) malloc(sizeof(edgenode));
+    *copy = *node;
+    *link = copy;
+    retireNode(cg, node);
+    link = &copy->next;
+  }
+
+  node = *link;
+  if(remove) {
+    *link = node->next;
+  } else {
+    copy = (edgenode *) malloc(sizeof(edgenode));
+    *copy = *node;
+    copy->weight = weight;
+    *link = copy;
+  }
+  retireNode(cg, node);
+}
+
+concurrentGraph * initializeConcurrentGraph(graph *g) {
+  concurrentGraph *cg = (concurrentGraph *) malloc(sizeof(concurrentGraph));
+  edgenode **last = NULL;
+  edgenode *node = NULL;
+
+  cg->g = initializeGraph(g->directed);
+  addVertex(cg->g, g->size);
+  for(int v = 0; v < g->size; v++) {
+    last = &cg->g->adjList[v];
+    for(edgenode *adj = g->adjList[v]; adj != NULL; adj = adj->next) {
+      node = (edgenode *) malloc(sizeof(edgenode));
+      node->edge = adj->edge;
+      node->weight = adj->weight;
+      *last = node;
+      last = &node->next;
+    }
+    *last = NULL;
+  }
+  if(g->removed != NULL) {
+    cg->g->lazyRemoval = g->lazyRemoval;
+    cg->g->removed = (bool *) malloc(sizeof(bool) * g->size);
+    memcpy(cg->g->removed, g->removed, sizeof(bool) * g->size);
+    cg->g->removedCount = g->removedCount;
+  }
+
+  cg->current = newSnapshot(cg->g, 0);
+  cg->oldest = cg->current;
+  cg->pending = NULL;
+  cg->npending = 0;
+  cg->pendingCapacity = 0;
+  pthread_mutex_init(&cg->snapshotLock, NULL);
+  pthread_mutex_init(&cg->writerLock, NULL);
+
+  return cg;
+}
+
+graphSnapshot * acquireSnapshot(concurrentGraph *cg) {
+  graphSnapshot *snapshot = NULL;
+
+  pthread_mutex_lock(&cg->snapshotLock);
+  snapshot = cg->current;
+  snapshot->readers += 1;
+  pthread_mutex_unlock(&cg->snapshotLock);
+
+  return snapshot;
+}
+
+void releaseSnapshot(concurrentGraph *cg, graphSnapshot *snapshot) {
+  pthread_mutex_lock(&cg->snapshotLock);
+  snapshot->readers -= 1;
+  reclaimSnapshots(cg);
+  pthread_mutex_unlock(&cg->snapshotLock);
+}
+
+bool concurrentAddVertex(concurrentGraph *cg, int n) {
+  bool added;
+
+  pthread_mutex_lock(&cg->writerLock);
+  added = addVertex(cg->g, n);
+  pthread_mutex_unlock(&cg->writerLock);
+
+  return added;
+}
+
+bool concurrentAddEdge(concurrentGraph *cg, int source, int destination, int weight) {
+  bool added;
+
+  /* the new nodes go in front of the lists, so no published node is changed */
+  pthread_mutex_lock(&cg->writerLock);
+  added = addEdgeWeight(cg->g, source, destination, weight);
+  pthread_mutex_unlock(&cg->writerLock);
+
+  return added;
+}
+
+bool concurrentRemoveEdge(concurrentGraph *cg, int source, int destination) {
+  pthread_mutex_lock(&cg->writerLock);
+  if(!containsEdge(cg->g, source, destination)) {
+    pthread_mutex_unlock(&cg->writerLock);
+    return false;
+  }
+
+  copyOnWrite(cg, source, destination, true, 0);
+  if(!cg->g->directed) {
+    copyOnWrite(cg, destination, source, true, 0);
+  }
+  pthread_mutex_unlock(&cg->writerLock);
+
+  return true;
+}
+
+bool concurrentSetEdgeWeight(concurrentGraph *cg, int source, int destination, int weight) {
+  pthread_mutex_lock(&cg->writerLock);
+  if(!containsEdge(cg->g, source, destination)) {
+    pthread_mutex_unlock(&cg->writerLock);
+    return false;
+  }
+
+  copyOnWrite(cg, source, destination, false, weight);
+  if(!cg->g->directed) {
+    copyOnWrite(cg, destination, source, false, weight);
+  }
+  pthread_mutex_unlock(&cg->writerLock);
+
+  return true;
+}
+
+long publishSnapshot(concurrentGraph *cg) {
+  graphSnapshot *snapshot = NULL;
+  long version;
+
+  pthread_mutex_lock(&cg->writerLock);
+  snapshot = newSnapshot(cg->g, 0);
+
+  pthread_mutex_lock(&cg->snapshotLock);
+  cg->current->retired = cg->pending;
+  cg->current->nretired = cg->npending;
+  cg->current->newer = snapshot;
+  snapshot->version = cg->current->version + 1;
+  version = snapshot->version;
+  cg->current = snapshot;
+  reclaimSnapshots(cg);
+  pthread_mutex_unlock(&cg->snapshotLock);
+
+  cg->pending = NULL;
+  cg->npending = 0;
+  cg->pendingCapacity = 0;
+  pthread_mutex_unlock(&cg->writerLock);
+
+  return version;
+}
+
+void destroyConcurrentGraph(concurrentGraph *cg) {
+  graphSnapshot *snapshot = NULL;
+
+  while(cg->oldest != NULL) {
+    snapshot = cg->oldest;
+    cg->oldest = snapshot->newer;
+    freeSnapshot(snapshot);
+  }
+  for(int i = 0; i < cg->npending; i++) {
+    free(cg->pending[i]);
+  }
+  free(cg->pending);
+  destroyGraph(cg->g);
+  pthread_mutex_destroy(&cg->snapshotLock);
+  pthread_mutex_destroy(&cg->writerLock);
+  free(cg);
+}
+
+/* CONCURRENT SNAPSHOTS - END */
+
+
+/* DEALLOCATING - START */
 
 void destroyVisit(visitInfo *visit) {
   free(visit->startTime);
@@ -811,10 +4748,18 @@ void destroyAdjList(edgenode *list) {
 }
 
 void destroyGraph(graph *g) {
+  if(g->view) {
+    free(g);
+    return;
+  }
+
   for(int i = 0; i < g->size; i++) {
     destroyAdjList(g->adjList[i]);
   }
+  disableReverseIndex(g);
+  disableDynamicConnectivity(g);
   free(g->adjList);
+  free(g->removed);
   free(g);
 }
 
@@ -4,9 +4,48 @@
  * @date August 9, 2021
  */
 
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <string.h>
 #include "../include/utility.h"
 
 
+/* STATISTICS - START */
+
+#ifdef GRAPH_STATS
+_Thread_local graphStats currentStats;
+_Thread_local long long currentPhaseStart[STATS_PHASES];
+#endif
+
+graphStats getGraphStats() {
+#ifdef GRAPH_STATS
+  return currentStats;
+#else
+  graphStats stats = {0};
+  return stats;
+#endif
+}
+
+void resetGraphStats() {
+#ifdef GRAPH_STATS
+  memset(&currentStats, 0, sizeof(currentStats));
+#endif
+}
+
+long long getStatsTime() {
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+/* STATISTICS - END */
+
+
 /* QUEUE - START */
 
 queue * initializeQueue() {
@@ -20,6 +59,7 @@ queue * initializeQueue() {
 
 void enqueue(queue *q, int value) {
   queuenode *el = (queuenode *) malloc(sizeof(queuenode));
+  STATS_ALLOC(sizeof(queuenode));
   el->value = value;
   el->priority = 0;
   el->next = NULL;
@@ -36,6 +76,7 @@ void enqueue(queue *q, int value) {
 }
 
 void enqueuePriority(queue *q, int value, int priority) {
+  STATS_ADD(heapOperations, 1);
   enqueue(q, value);
   q->last->priority = priority;
 }
@@ -56,6 +97,7 @@ int dequeue(queue *q) {
 int dequeuePriority(queue *q) {
   if(q->size <= 0) return -9999; // gestire meglio
 
+  STATS_ADD(heapOperations, 1);
   queuenode *temp = q->first;
   queuenode *prev = NULL;
   queuenode *minPrev = NULL;
@@ -87,6 +129,7 @@ int dequeuePriority(queue *q) {
 void editPriority(queue *q, int value, int newPriority) {
   queuenode *temp = q->first;
 
+  STATS_ADD(heapOperations, 1);
   while(temp != NULL) {
     if(temp->value == value) {
       temp->priority = newPriority;
@@ -110,6 +153,68 @@ void destroyQueue(queue *q) {
 /* QUEUE - END */
 
 
+/* HEAP - START */
+
+heap * initializeHeap(int capacity) {
+  heap *h = (heap *) malloc(sizeof(heap));
+  h->capacity = capacity > 0 ? capacity : 1;
+  h->nodes = (heapnode *) malloc(sizeof(heapnode) * h->capacity);
+  h->size = 0;
+  STATS_ALLOC(sizeof(heap) + sizeof(heapnode) * h->capacity);
+
+  return h;
+}
+
+void heapPush(heap *h, int value, int priority) {
+  heapnode node = {value, priority};
+  int i = h->size;
+
+  STATS_ADD(heapOperations, 1);
+  if(h->size == h->capacity) {
+    h->capacity *= 2;
+    h->nodes = (heapnode *) realloc(h->nodes, sizeof(heapnode) * h->capacity);
+    STATS_ALLOC(sizeof(heapnode) * h->capacity);
+  }
+
+  while(i > 0 && h->nodes[(i-1)/2].priority > priority) {
+    h->nodes[i] = h->nodes[(i-1)/2];
+    i = (i-1)/2;
+  }
+  h->nodes[i] = node;
+  h->size += 1;
+}
+
+int heapPop(heap *h, int *priority) {
+  if(h->size <= 0) return -1;
+
+  heapnode top = h->nodes[0];
+  heapnode last = h->nodes[--h->size];
+  int i = 0;
+  int child;
+
+  STATS_ADD(heapOperations, 1);
+  while((child = 2*i + 1) < h->size) {
+    if(child + 1 < h->size && h->nodes[child+1].priority < h->nodes[child].priority) {
+      child += 1;
+    }
+    if(h->nodes[child].priority >= last.priority) break;
+    h->nodes[i] = h->nodes[child];
+    i = child;
+  }
+  h->nodes[i] = last;
+
+  if(priority != NULL) *priority = top.priority;
+  return top.value;
+}
+
+void destroyHeap(heap *h) {
+  free(h->nodes);
+  free(h);
+}
+
+/* HEAP - END */
+
+
 /* LIST OF LINKED-LIST - START */
 
 lists * initializeLists() {
@@ -192,6 +297,8 @@ void k_union(k_union_find *kunion, int a, int b) {
   int x = k_find(kunion, a);
   int y = k_find(kunion, b);
 
+  if(x == y) return;
+
   if(kunion->rank[x] > kunion->rank[y]) {
     kunion->parent[y] = x;
   } else {
@@ -205,6 +312,7 @@ void k_union(k_union_find *kunion, int a, int b) {
 
 int k_find(k_union_find *kunion, int a) {
   while(kunion->parent[a] != a) {
+    kunion->parent[a] = kunion->parent[kunion->parent[a]];
     a = kunion->parent[a];
   }
 
@@ -220,6 +328,435 @@ void destroyKUnionFind(k_union_find *kunion) {
 /* K-UNION-FIND - END */
 
 
+/* C-UNION-FIND - START */
+
+c_union_find *initializeCUnionFind(int size) {
+  c_union_find *cunion = (c_union_find *) malloc(sizeof(c_union_find));
+  cunion->parent = (atomic_int *) malloc(sizeof(atomic_int) * size);
+  cunion->size = size;
+
+  for(int i = 0; i < size; i++) {
+    atomic_init(&cunion->parent[i], i);
+  }
+
+  return cunion;
+}
+
+bool c_union(c_union_find *cunion, int a, int b) {
+  int root;
+
+  while(true) {
+    a = c_find(cunion, a);
+    b = c_find(cunion, b);
+    if(a == b) return false;
+
+    if(a < b) {
+      root = a;
+      a = b;
+      b = root;
+    }
+
+    root = a;
+    if(atomic_compare_exchange_weak(&cunion->parent[a], &root, b)) {
+      return true;
+    }
+  }
+}
+
+int c_find(c_union_find *cunion, int a) {
+  int parent;
+  int grandparent;
+
+  while(true) {
+    parent = atomic_load_explicit(&cunion->parent[a], memory_order_relaxed);
+    if(parent == a) return a;
+
+    grandparent = atomic_load_explicit(&cunion->parent[parent], memory_order_relaxed);
+    if(parent != grandparent) {
+      atomic_compare_exchange_weak(&cunion->parent[a], &parent, grandparent);
+    }
+    a = grandparent;
+  }
+}
+
+void destroyCUnionFind(c_union_find *cunion) {
+  free(cunion->parent);
+  free(cunion);
+}
+
+/* C-UNION-FIND - END */
+
+
+/* PARALLEL - START */
+
+typedef struct parallelJob parallelJob;
+
+/**
+ * A call of parallelForGrain: remaining is the number of indexes whose chunk is not done yet.
+ */
+struct parallelJob {
+  void (*fun)(int chunkStart, int chunkEnd, void *arg);
+  void *arg;
+  int grain;
+  atomic_int remaining;
+};
+
+typedef struct rangeTask rangeTask;
+
+struct rangeTask {
+  int start;
+  int end;
+  parallelJob *job;
+};
+
+typedef struct workDeque workDeque;
+
+/**
+ * The owner pushes and pops the tasks at the tail, the other threads steal them from the head
+ * (the oldest tasks, which are the biggest ranges).
+ */
+struct workDeque {
+  rangeTask *tasks;
+  int head;
+  int tail;
+  int capacity;
+  pthread_mutex_t lock;
+};
+
+typedef struct threadPool threadPool;
+
+/**
+ * Deque 0 belongs to the threads outside of the pool, deque i to worker i.
+ * The workers sleep when there are no active jobs.
+ */
+struct threadPool {
+  int nthreads;
+  pthread_t *threads;
+  workDeque *deques;
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  int activeJobs;
+  bool shutdown;
+};
+
+static int numberOfThreads = 0;
+static threadPool *pool = NULL;
+static pthread_mutex_t poolLock = PTHREAD_MUTEX_INITIALIZER;
+static _Thread_local int workerId = 0;
+
+static void pushTask(workDeque *d, rangeTask task) {
+  pthread_mutex_lock(&d->lock);
+  if(d->tail == d->capacity) {
+    if(d->head > 0) {
+      memmove(d->tasks, &d->tasks[d->head], sizeof(rangeTask) * (d->tail - d->head));
+      d->tail -= d->head;
+      d->head = 0;
+    } else {
+      d->capacity *= 2;
+      d->tasks = (rangeTask *) realloc(d->tasks, sizeof(rangeTask) * d->capacity);
+    }
+  }
+  d->tasks[d->tail++] = task;
+  pthread_mutex_unlock(&d->lock);
+}
+
+static bool popTask(workDeque *d, rangeTask *task, bool steal) {
+  bool found = false;
+
+  pthread_mutex_lock(&d->lock);
+  if(d->tail > d->head) {
+    *task = steal ? d->tasks[d->head++] : d->tasks[--d->tail];
+    found = true;
+  }
+  if(d->head == d->tail) {
+    d->head = 0;
+    d->tail = 0;
+  }
+  pthread_mutex_unlock(&d->lock);
+
+  return found;
+}
+
+static bool findTask(threadPool *p, int self, rangeTask *task) {
+  if(popTask(&p->deques[self], task, false)) return true;
+
+  for(int i = 1; i < p->nthreads; i++) {
+    if(popTask(&p->deques[(self + i) % p->nthreads], task, true)) return true;
+  }
+
+  return false;
+}
+
+/**
+ * The range is halved until it is not bigger than the grain: the right halves go in the deque of the thread,
+ * where the other threads can steal them.
+ */
+static void runTask(threadPool *p, int self, rangeTask task) {
+  rangeTask half;
+
+  while(task.end - task.start > task.job->grain) {
+    half.start = task.start + (task.end - task.start) / 2;
+    half.end = task.end;
+    half.job = task.job;
+    pushTask(&p->deques[self], half);
+    task.end = half.start;
+  }
+
+  task.job->fun(task.start, task.end, task.job->arg);
+  atomic_fetch_sub(&task.job->remaining, task.end - task.start);
+}
+
+static void * workerRun(void *arg) {
+  threadPool *p = pool;
+  rangeTask task;
+  bool stop;
+
+  workerId = (int) (long) arg;
+  while(true) {
+    if(findTask(p, workerId, &task)) {
+      runTask(p, workerId, task);
+      continue;
+    }
+
+    pthread_mutex_lock(&p->lock);
+    while(p->activeJobs == 0 && !p->shutdown) {
+      pthread_cond_wait(&p->wake, &p->lock);
+    }
+    stop = p->shutdown;
+    pthread_mutex_unlock(&p->lock);
+    if(stop) return NULL;
+    sched_yield();
+  }
+}
+
+static void destroyPool() {
+  pthread_mutex_lock(&pool->lock);
+  pool->shutdown = true;
+  pthread_cond_broadcast(&pool->wake);
+  pthread_mutex_unlock(&pool->lock);
+
+  for(int i = 1; i < pool->nthreads; i++) {
+    pthread_join(pool->threads[i], NULL);
+  }
+  for(int i = 0; i < pool->nthreads; i++) {
+    pthread_mutex_destroy(&pool->deques[i].lock);
+    free(pool->deques[i].tasks);
+  }
+  pthread_mutex_destroy(&pool->lock);
+  pthread_cond_destroy(&pool->wake);
+  free(pool->deques);
+  free(pool->threads);
+  free(pool);
+  pool = NULL;
+}
+
+static threadPool * getPool(int nthreads) {
+  pthread_mutex_lock(&poolLock);
+  if(pool != NULL && pool->nthreads != nthreads) {
+    destroyPool();
+  }
+  if(pool == NULL) {
+    pool = (threadPool *) malloc(sizeof(threadPool));
+    pool->nthreads = nthreads;
+    pool->threads = (pthread_t *) malloc(sizeof(pthread_t) * nthreads);
+    pool->deques = (workDeque *) malloc(sizeof(workDeque) * nthreads);
+    pool->activeJobs = 0;
+    pool->shutdown = false;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    for(int i = 0; i < nthreads; i++) {
+      pool->deques[i].capacity = 64;
+      pool->deques[i].tasks = (rangeTask *) malloc(sizeof(rangeTask) * pool->deques[i].capacity);
+      pool->deques[i].head = 0;
+      pool->deques[i].tail = 0;
+      pthread_mutex_init(&pool->deques[i].lock, NULL);
+    }
+    for(int i = 1; i < nthreads; i++) {
+      pthread_create(&pool->threads[i], NULL, workerRun, (void *) (long) i);
+    }
+  }
+  pthread_mutex_unlock(&poolLock);
+
+  return pool;
+}
+
+int getNumberOfThreads() {
+  if(numberOfThreads == 0) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    numberOfThreads = n > 0 ? (int) n : 1;
+  }
+
+  return numberOfThreads;
+}
+
+void setNumberOfThreads(int n) {
+  numberOfThreads = n < 1 ? 1 : n;
+
+  pthread_mutex_lock(&poolLock);
+  if(pool != NULL && pool->nthreads != numberOfThreads) {
+    destroyPool();
+  }
+  pthread_mutex_unlock(&poolLock);
+}
+
+int getWorkerId() {
+  return workerId;
+}
+
+void parallelFor(int start, int end, void (*fun)(int chunkStart, int chunkEnd, void *arg), void *arg) {
+  int nthreads = getNumberOfThreads();
+
+  parallelForGrain(start, end, (end - start) / (4 * nthreads) + 1, fun, arg);
+}
+
+/**
+ * The calling thread splits the range like a worker, then it runs the tasks of its deque and steals the other ones
+ * until all the indexes of its job are done.
+ */
+void parallelForGrain(int start, int end, int grain, void (*fun)(int chunkStart, int chunkEnd, void *arg), void *arg) {
+  int nthreads = getNumberOfThreads();
+  threadPool *p = NULL;
+  parallelJob job;
+  rangeTask task;
+
+  if(end - start <= 0) return;
+  if(grain < 1) grain = 1;
+  if(nthreads == 1 || end - start <= grain) {
+    fun(start, end, arg);
+    return;
+  }
+
+  p = getPool(nthreads);
+  job.fun = fun;
+  job.arg = arg;
+  job.grain = grain;
+  atomic_init(&job.remaining, end - start);
+
+  pthread_mutex_lock(&p->lock);
+  p->activeJobs += 1;
+  pthread_cond_broadcast(&p->wake);
+  pthread_mutex_unlock(&p->lock);
+
+  task.start = start;
+  task.end = end;
+  task.job = &job;
+  runTask(p, workerId, task);
+  while(atomic_load(&job.remaining) > 0) {
+    if(findTask(p, workerId, &task)) {
+      runTask(p, workerId, task);
+    } else {
+      sched_yield();
+    }
+  }
+
+  pthread_mutex_lock(&p->lock);
+  p->activeJobs -= 1;
+  pthread_mutex_unlock(&p->lock);
+}
+
+workerBuffers * initializeWorkerBuffers(size_t bytes) {
+  workerBuffers *buffers = (workerBuffers *) malloc(sizeof(workerBuffers));
+  buffers->nthreads = getNumberOfThreads();
+  buffers->threads = (workerBuffer *) malloc(sizeof(workerBuffer) * buffers->nthreads);
+  buffers->bytes = bytes;
+  atomic_init(&buffers->extra, NULL);
+
+  for(int i = 0; i < buffers->nthreads; i++) {
+    buffers->threads[i].data = NULL;
+    atomic_init(&buffers->threads[i].busy, false);
+    buffers->threads[i].next = NULL;
+  }
+
+  return buffers;
+}
+
+/**
+ * The buffer of the worker is busy when the calling thread is already using it (a nested parallel call) or when
+ * another thread outside of the pool shares the worker id 0: a free extra buffer is taken, or a new one is pushed.
+ */
+void * acquireWorkerBuffer(workerBuffers *buffers) {
+  int id = getWorkerId();
+  workerBuffer *buffer = NULL;
+
+  if(id < buffers->nthreads && !atomic_exchange(&buffers->threads[id].busy, true)) {
+    buffer = &buffers->threads[id];
+  } else {
+    for(buffer = atomic_load(&buffers->extra); buffer != NULL; buffer = buffer->next) {
+      if(!atomic_exchange(&buffer->busy, true)) break;
+    }
+    if(buffer == NULL) {
+      // The data is allocated before the buffer is published: the other threads only read it
+      buffer = (workerBuffer *) malloc(sizeof(workerBuffer));
+      buffer->data = calloc(1, buffers->bytes);
+      atomic_init(&buffer->busy, true);
+      buffer->next = atomic_load(&buffers->extra);
+      while(!atomic_compare_exchange_weak(&buffers->extra, &buffer->next, buffer));
+    }
+  }
+
+  if(buffer->data == NULL) {
+    buffer->data = calloc(1, buffers->bytes);
+  }
+  return buffer->data;
+}
+
+/**
+ * The extra buffers are looked at first: their data never changes after they are published, while the data of the
+ * buffer of worker 0 can be set by another thread outside of the pool.
+ */
+void releaseWorkerBuffer(workerBuffers *buffers, void *data) {
+  workerBuffer *buffer = NULL;
+
+  for(buffer = atomic_load(&buffers->extra); buffer != NULL; buffer = buffer->next) {
+    if(buffer->data == data) {
+      atomic_store(&buffer->busy, false);
+      return;
+    }
+  }
+  atomic_store(&buffers->threads[getWorkerId()].busy, false);
+}
+
+void ** getWorkerBuffers(workerBuffers *buffers, int *n) {
+  workerBuffer *buffer = NULL;
+  void **data = NULL;
+  int count = 0;
+
+  for(buffer = atomic_load(&buffers->extra); buffer != NULL; buffer = buffer->next) {
+    count += 1;
+  }
+  data = (void **) malloc(sizeof(void *) * (buffers->nthreads + count));
+  count = 0;
+  for(int i = 0; i < buffers->nthreads; i++) {
+    if(buffers->threads[i].data != NULL) data[count++] = buffers->threads[i].data;
+  }
+  for(buffer = atomic_load(&buffers->extra); buffer != NULL; buffer = buffer->next) {
+    data[count++] = buffer->data;
+  }
+
+  *n = count;
+  return data;
+}
+
+void destroyWorkerBuffers(workerBuffers *buffers) {
+  workerBuffer *buffer = atomic_load(&buffers->extra);
+  workerBuffer *next = NULL;
+
+  for(int i = 0; i < buffers->nthreads; i++) {
+    free(buffers->threads[i].data);
+  }
+  while(buffer != NULL) {
+    next = buffer->next;
+    free(buffer->data);
+    free(buffer);
+    buffer = next;
+  }
+  free(buffers->threads);
+  free(buffers);
+}
+
+/* PARALLEL - END */
+
+
 /* COMPARE FUNCTIONS - START */
 
 int compareFunUtil1(const void *a, const void *b) {
@@ -14,22 +14,77 @@ graph * prepareDirectedGraphTest();
 graph * prepareUndirectedGraphTest();
 graph * editDirectedGraphTest(graph *g);
 graph * editUndirectedGraphTest(graph *g);
+graph * prepareRandomUndirectedGraph(int size, int degree, unsigned int seed);
+bool sameLists(lists *a, lists *b);
+int getTotalWeight(graph *g);
+bool sameGraph(graph *a, graph *b);
+bool validReverseIndex(graph *g);
 void BFSTest(graph *g);
 void DFSTest(graph *g);
 void DFSTotForestTest(graph * g);
 void isCyclicTest(graph *g);
 void connectedComponentsTest(graph *g);
+void parallelConnectedComponentsTest(graph *g);
 void stronglyConnectedComponentsTest(graph *g);
 void getTopologicalSortTest(graph *g);
+void getKahnTopologicalSortTest(graph *g);
 void getDijkstraShortestPathsTest(graph *g);
 void getBellmanFordShortestPathsTest(graph *g);
 void getFloydWarshallShortestsPathsTest(graph *g);
 void getPrimMSTTest(graph *g);
 void getKruskalMSTTest(graph *g);
+void sortEdgesByWeightTest();
+void getFilterKruskalMSTTest(graph *g);
+void getBoruvkaMSTTest(graph *g);
+void getMSFTest(graph *g);
+void lazyVertexRemovalTest();
+void batchMutationTest();
+void dynamicSSSPTest();
+void dynamicConnectivityTest();
+void graphStatsTest();
+void reorderGraphTest();
+void compressedGraphTest();
+void neighbourIterationTest();
+void reverseIndexTest();
+void concurrentGraphTest();
+void * concurrentReader(void *arg);
+void threadPoolTest();
+void queryBatchTest();
+void multiSourceBFSTest();
+void centralityTest();
+bool closeTo(double a, double b, double epsilon);
+void pageRankTest();
+void triangleTest();
+void kCoreTest();
+void biconnectedComponentsTest();
+void maxFlowTest();
+bool validMaximumFlow(flowNetwork *f, int source, int sink, long long value);
+int countComponentsWithout(graph *g, int vertex, int source, int destination, int component, biconnectedComponents *b);
+void countChunk(int start, int end, void *arg);
+void nestedChunk(int start, int end, void *arg);
 
 int main() {
   directedGraphTest();
   undirectedGraphTest();
+  lazyVertexRemovalTest();
+  batchMutationTest();
+  dynamicSSSPTest();
+  dynamicConnectivityTest();
+  graphStatsTest();
+  reorderGraphTest();
+  compressedGraphTest();
+  neighbourIterationTest();
+  reverseIndexTest();
+  concurrentGraphTest();
+  threadPoolTest();
+  queryBatchTest();
+  multiSourceBFSTest();
+  centralityTest();
+  pageRankTest();
+  triangleTest();
+  kCoreTest();
+  biconnectedComponentsTest();
+  maxFlowTest();
 
   printf("All tests passed.\n");
 
@@ -46,6 +101,7 @@ void directedGraphTest() {
   isCyclicTest(g);
   stronglyConnectedComponentsTest(g);
   getTopologicalSortTest(g);
+  getKahnTopologicalSortTest(g);
   destroyGraph(g);
   g = prepareDirectedGraphTest();
   getDijkstraShortestPathsTest(g);
@@ -60,8 +116,13 @@ void undirectedGraphTest() {
   g = editUndirectedGraphTest(g);
 
   connectedComponentsTest(g);
+  parallelConnectedComponentsTest(g);
   getPrimMSTTest(g);
   getKruskalMSTTest(g);
+  sortEdgesByWeightTest();
+  getFilterKruskalMSTTest(g);
+  getBoruvkaMSTTest(g);
+  getMSFTest(g);
 
   destroyGraph(g);
 }
@@ -243,6 +304,84 @@ void connectedComponentsTest(graph *g) {
   removeVertex(g, 6);
 }
 
+bool sameLists(lists *a, lists *b) {
+  listnode *x = NULL;
+  listnode *y = NULL;
+
+  if(a->size != b->size) return false;
+  for(int i = 0; i < a->size; i++) {
+    x = a->linkedLists[i];
+    y = b->linkedLists[i];
+    while(x != NULL && y != NULL && x->value == y->value) {
+      x = x->next;
+      y = y->next;
+    }
+    if(x != NULL || y != NULL) return false;
+  }
+
+  return true;
+}
+
+void parallelConnectedComponentsTest(graph *g) {
+  graph *big = initializeGraph(false);
+  lists *expected = NULL;
+  lists *actual = NULL;
+
+  addVertex(g, 3);
+  addEdge(g, 6, 8);
+  expected = getConnectedComponents(g);
+  for(int t = 1; t <= 4; t *= 2) {
+    setNumberOfThreads(t);
+    actual = getParallelConnectedComponents(g);
+    assert(sameLists(expected, actual) == true);
+    destroyLists(actual);
+  }
+  destroyLists(expected);
+  removeVertex(g, 8);
+  removeVertex(g, 7);
+  removeVertex(g, 6);
+
+  /* the tombstones of a lazy removal are not components */
+  addVertex(big, 6);
+  for(int v = 0; v < 5; v++) {
+    addEdge(big, v, v + 1);
+  }
+  setLazyVertexRemoval(big, true);
+  removeVertex(big, 0);
+  removeVertex(big, 3);
+  expected = getConnectedComponents(big);
+  assert(expected->size == 2);
+  for(int t = 1; t <= 4; t *= 2) {
+    setNumberOfThreads(t);
+    actual = getParallelConnectedComponents(big);
+    assert(sameLists(expected, actual) == true);
+    destroyLists(actual);
+  }
+  assert(getNumberOfComponents(big) == 2);
+  destroyLists(expected);
+  destroyGraph(big);
+  big = initializeGraph(false);
+
+  addVertex(big, 3000);
+  for(int v = 0; v < 3000; v++) {
+    if(v % 7 != 0) {
+      addEdge(big, v, (v * 31 + 11) % 3000);
+    }
+  }
+  expected = getConnectedComponents(big);
+  setNumberOfThreads(4);
+  actual = getParallelConnectedComponents(big);
+  assert(sameLists(expected, actual) == true);
+  destroyLists(actual);
+  destroyLists(expected);
+  destroyGraph(big);
+
+  big = initializeGraph(true);
+  assert(getParallelConnectedComponents(big) == NULL);
+  destroyGraph(big);
+  setNumberOfThreads(1);
+}
+
 void stronglyConnectedComponentsTest(graph *g) {
   int expectedCC[][3] = {{5}, {0, 1, 3}, {2, 4}};
   lists *scc = NULL;
@@ -287,6 +426,28 @@ void getTopologicalSortTest(graph *g) {
   free(actualOrder);
 }
 
+void getKahnTopologicalSortTest(graph *g) {
+  int expectedOrder[] = {0, 5, 3, 1, 4, 2};
+  int expectedLevel[] = {0, 1, 3, 1, 2, 0};
+  lists *levels = NULL;
+  int *actualOrder = getKahnTopologicalSort(g, &levels);
+
+  for(int i = 0; i < g->size; i++) {
+    assert(actualOrder[i] == expectedOrder[i]);
+  }
+  assert(levels->size == 4);
+  for(int i = 0; i < g->size; i++) {
+    assert(containsNode(levels, i, expectedLevel[i]) == true);
+  }
+  free(actualOrder);
+  destroyLists(levels);
+
+  addEdge(g, 4, 0);
+  assert(getKahnTopologicalSort(g, &levels) == NULL);
+  assert(levels == NULL);
+  removeEdge(g, 4, 0);
+}
+
 void getDijkstraShortestPathsTest(graph *g) {
   int expectedDistance[] = {0, 3, 4, 6, 1, 3};
   visitInfo *visit = getDijkstraShortestPaths(g, 0);
@@ -351,4 +512,1925 @@ void getKruskalMSTTest(graph *g) {
   }
 
   destroyGraph(mst);
+}
+
+int getTotalWeight(graph *g) {
+  int nedges;
+  int total = 0;
+  weightedEdge *edges = getEdges(g, &nedges);
+
+  for(int i = 0; i < nedges; i++) {
+    total += edges[i].weight;
+  }
+  free(edges);
+
+  return total;
+}
+
+graph * prepareRandomUndirectedGraph(int size, int degree, unsigned int seed) {
+  graph *g = initializeGraph(false);
+
+  addVertex(g, size);
+  for(int v = 0; v < size; v++) {
+    seed = seed * 1103515245 + 12345;
+    addEdgeWeight(g, v, (v+1) % size, (seed >> 16) % 1000);
+    for(int i = 0; i < degree; i++) {
+      seed = seed * 1103515245 + 12345;
+      int u = (seed >> 8) % size;
+      seed = seed * 1103515245 + 12345;
+      addEdgeWeight(g, v, u, (seed >> 16) % 1000);
+    }
+  }
+
+  return g;
+}
+
+void sortEdgesByWeightTest() {
+  weightedEdge edges[2000];
+
+  for(int t = 1; t <= 4; t *= 2) {
+    setNumberOfThreads(t);
+    for(int i = 0; i < 2000; i++) {
+      edges[i].source = i;
+      edges[i].destination = i;
+      edges[i].weight = ((i * 7919) % 2003) * (i % 2 == 0 ? 1 : -300);
+    }
+    sortEdgesByWeight(edges, 2000);
+    for(int i = 1; i < 2000; i++) {
+      assert(edges[i-1].weight <= edges[i].weight);
+    }
+  }
+  setNumberOfThreads(1);
+}
+
+void getFilterKruskalMSTTest(graph *g) {
+  int expectedEdge[][3] = {{0, 5, 1}, {0, 1, 1}, {5, 3, 2}, {3, 4, 1}, {4, 2, 3}};
+  graph *mst = getFilterKruskalMST(g);
+  graph *big = prepareRandomUndirectedGraph(3000, 4, 7);
+  graph *expected = NULL;
+
+  assert(getNumberOfEdges(mst) == 5);
+  for(int i = 0; i < 5; i++) {
+    assert(containsEdge(mst, expectedEdge[i][0], expectedEdge[i][1]) == true);
+    assert(getEdgeWeight(mst, expectedEdge[i][0], expectedEdge[i][1]) == expectedEdge[i][2]);
+  }
+  destroyGraph(mst);
+
+  expected = getKruskalMST(big);
+  setNumberOfThreads(4);
+  mst = getFilterKruskalMST(big);
+  assert(getNumberOfEdges(mst) == 2999);
+  assert(getTotalWeight(mst) == getTotalWeight(expected));
+  setNumberOfThreads(1);
+  destroyGraph(mst);
+  destroyGraph(expected);
+  destroyGraph(big);
+
+  // Skewed weights: almost all the edges fall in the equal part of the first split
+  big = initializeGraph(false);
+  addVertex(big, 5000);
+  for(int i = 0; i < 5000; i++) {
+    addEdgeWeight(big, i, (i + 1) % 5000, i % 997 == 0 ? i : 1);
+    addEdgeWeight(big, i, (i + 7) % 5000, i % 5 == 0 ? 5000 - i : 2);
+  }
+  expected = getKruskalMST(big);
+  mst = getFilterKruskalMST(big);
+  assert(getNumberOfEdges(mst) == 4999);
+  assert(getTotalWeight(mst) == getTotalWeight(expected));
+
+  destroyGraph(mst);
+  destroyGraph(expected);
+  destroyGraph(big);
+}
+
+void getBoruvkaMSTTest(graph *g) {
+  int expectedEdge[][3] = {{0, 5, 1}, {0, 1, 1}, {5, 3, 2}, {3, 4, 1}, {4, 2, 3}};
+  graph *mst = NULL;
+  graph *big = prepareRandomUndirectedGraph(3000, 4, 11);
+  graph *expected = getKruskalMST(big);
+
+  for(int t = 1; t <= 4; t *= 2) {
+    setNumberOfThreads(t);
+    mst = getBoruvkaMST(g);
+    assert(getNumberOfEdges(mst) == 5);
+    for(int i = 0; i < 5; i++) {
+      assert(containsEdge(mst, expectedEdge[i][0], expectedEdge[i][1]) == true);
+      assert(getEdgeWeight(mst, expectedEdge[i][0], expectedEdge[i][1]) == expectedEdge[i][2]);
+    }
+    destroyGraph(mst);
+
+    mst = getBoruvkaMST(big);
+    assert(getNumberOfEdges(mst) == 2999);
+    assert(getTotalWeight(mst) == getTotalWeight(expected));
+    destroyGraph(mst);
+  }
+
+  addVertex(g, 3);
+  addEdgeWeight(g, 6, 7, 5);
+  mst = getBoruvkaMST(g);
+  assert(getNumberOfEdges(mst) == 6);
+  assert(containsEdge(mst, 6, 7) == true);
+  assert(getTotalWeight(mst) == 13);
+  destroyGraph(mst);
+  removeVertex(g, 8);
+  removeVertex(g, 7);
+  removeVertex(g, 6);
+
+  setNumberOfThreads(1);
+  destroyGraph(expected);
+  destroyGraph(big);
+}
+
+void getMSFTest(graph *g) {
+  graph *(*msf[])(graph *, int *) = {getPrimMSF, getKruskalMSF};
+  graph *big = prepareRandomUndirectedGraph(3000, 4, 13);
+  graph *expected = getBoruvkaMST(big);
+  graph *forest = NULL;
+  int ntrees;
+
+  addVertex(g, 3);
+  addEdgeWeight(g, 6, 7, 5);
+  assert(getPrimMST(g) == NULL);
+  assert(getKruskalMST(g) == NULL);
+
+  for(int i = 0; i < 2; i++) {
+    forest = msf[i](g, &ntrees);
+    assert(ntrees == 3);
+    assert(getNumberOfEdges(forest) == 6);
+    assert(containsEdge(forest, 6, 7) == true);
+    assert(getTotalWeight(forest) == 13);
+    destroyGraph(forest);
+
+    forest = msf[i](big, &ntrees);
+    assert(ntrees == 1);
+    assert(getTotalWeight(forest) == getTotalWeight(expected));
+    destroyGraph(forest);
+  }
+
+  removeVertex(g, 8);
+  removeVertex(g, 7);
+  removeVertex(g, 6);
+  destroyGraph(expected);
+  destroyGraph(big);
+
+  /* a tombstone is not a tree of its own: the cycle stays connected without vertex 2 */
+  big = initializeGraph(false);
+  addVertex(big, 6);
+  for(int v = 0; v < 6; v++) {
+    addEdgeWeight(big, v, (v + 1) % 6, v + 1);
+  }
+  addEdgeWeight(big, 0, 3, 2);
+  setLazyVertexRemoval(big, true);
+  removeVertex(big, 2);
+  for(int i = 0; i < 2; i++) {
+    forest = msf[i](big, &ntrees);
+    assert(ntrees == 1);
+    destroyGraph(forest);
+  }
+  forest = getPrimMST(big);
+  expected = getKruskalMST(big);
+  assert(forest != NULL && expected != NULL);
+  assert(getNumberOfEdges(forest) == 4 && getNumberOfEdges(expected) == 4);
+  assert(getTotalWeight(forest) == getTotalWeight(expected));
+  destroyGraph(forest);
+  destroyGraph(expected);
+  destroyGraph(big);
+}
+
+void lazyVertexRemovalTest() {
+  graph *g = NULL;
+  graph *mst = NULL;
+  int *newId = NULL;
+  int expectedId[] = {0, -1, 1, -1, 2, 3};
+
+  for(int directed = 0; directed < 2; directed++) {
+    g = directed ? prepareDirectedGraphTest() : prepareUndirectedGraphTest();
+    setLazyVertexRemoval(g, true);
+
+    assert(removeVertex(g, 1) == true);
+    assert(removeVertex(g, 1) == false);
+    assert(removeVertex(g, 3) == true);
+    assert(g->size == 6);
+    assert(g->removedCount == 2);
+    assert(containsVertex(g, 1) == false);
+    assert(containsEdge(g, 0, 1) == false);
+    assert(containsEdge(g, 5, 3) == false);
+    assert(addEdge(g, 0, 3) == false);
+    assert(containsEdge(g, 2, 4) == true);
+    assert(getNumberOfEdges(g) == (directed ? 6 : 4));
+
+    addVertex(g, 1);
+    assert(containsVertex(g, 6) == true);
+    addEdgeWeight(g, 6, 4, 8);
+
+    newId = compactGraph(g);
+    for(int i = 0; i < 6; i++) {
+      assert(newId[i] == expectedId[i]);
+    }
+    assert(newId[6] == 4);
+    assert(g->size == 5);
+    assert(g->removedCount == 0);
+    assert(getEdgeWeight(g, 4, 2) == 8);
+    assert(containsEdge(g, 0, 2) == true);
+    assert(getNumberOfEdges(g) == (directed ? 7 : 5));
+
+    free(newId);
+    destroyGraph(g);
+
+    // A vertex with a self-loop
+    g = initializeGraph(directed);
+    setLazyVertexRemoval(g, true);
+    addVertex(g, 3);
+    addEdge(g, 0, 0);
+    addEdge(g, 0, 1);
+    addEdge(g, 2, 0);
+    assert(removeVertex(g, 0) == true);
+    assert(getNumberOfEdges(g) == 0 && getAdjacent(g, 1) == NULL && getAdjacent(g, 2) == NULL);
+    destroyGraph(g);
+  }
+
+  // The tombstones don't disconnect the graph
+  g = initializeGraph(false);
+  setLazyVertexRemoval(g, true);
+  addVertex(g, 4);
+  addEdge(g, 0, 1);
+  addEdge(g, 1, 2);
+  addEdge(g, 2, 3);
+  removeVertex(g, 3);
+  assert(isConnected(g) == true);
+  removeVertex(g, 0);
+  assert(isConnected(g) == true);
+  mst = getFilterKruskalMST(g);
+  assert(mst != NULL && getNumberOfEdges(mst) == 1);
+  destroyGraph(mst);
+  removeEdge(g, 1, 2);
+  assert(isConnected(g) == false);
+  destroyGraph(g);
+
+  g = initializeGraph(true);
+  setLazyVertexRemoval(g, true);
+  addVertex(g, 4);
+  addEdge(g, 1, 2);
+  addEdge(g, 2, 3);
+  addEdge(g, 3, 1);
+  addEdge(g, 0, 1);
+  assert(isStronglyConnected(g) == false);
+  removeVertex(g, 0);
+  assert(isStronglyConnected(g) == true);
+  destroyGraph(g);
+}
+
+bool sameGraph(graph *a, graph *b) {
+  edgenode *adj = NULL;
+
+  if(a->size != b->size || getNumberOfEdges(a) != getNumberOfEdges(b)) return false;
+  for(int v = 0; v < a->size; v++) {
+    adj = a->adjList[v];
+    while(adj != NULL) {
+      if(!containsEdge(b, v, adj->edge) || getEdgeWeight(b, v, adj->edge) != adj->weight) return false;
+      adj = adj->next;
+    }
+  }
+
+  return true;
+}
+
+void batchMutationTest() {
+  edgeMutation mutations[4000];
+  graph *expected = NULL;
+  graph *actual = NULL;
+  unsigned int seed = 17;
+  int applied;
+  int vertices[] = {3, 40, 3, 199, -1};
+  bool ok;
+
+  for(int directed = 0; directed < 2; directed++) {
+    for(int parallel = 0; parallel < 2; parallel++) {
+      expected = initializeGraph(directed);
+      actual = initializeGraph(directed);
+      addVertex(expected, 200);
+      addVertex(actual, 200);
+      setNumberOfThreads(4);
+
+      for(int round = 0; round < 3; round++) {
+        applied = 0;
+        for(int i = 0; i < 4000; i++) {
+          seed = seed * 1103515245 + 12345;
+          mutations[i].type = round == 0 ? INSERT_EDGE : (enum mutationType) ((seed >> 16) % 3);
+          seed = seed * 1103515245 + 12345;
+          mutations[i].source = (seed >> 16) % 201;
+          seed = seed * 1103515245 + 12345;
+          mutations[i].destination = (seed >> 16) % 200;
+          mutations[i].weight = i;
+
+          if(!directed && mutations[i].source == mutations[i].destination) {
+            ok = false;
+          } else if(mutations[i].type == INSERT_EDGE) {
+            ok = addEdgeWeight(expected, mutations[i].source, mutations[i].destination, mutations[i].weight);
+          } else if(mutations[i].type == DELETE_EDGE) {
+            ok = removeEdge(expected, mutations[i].source, mutations[i].destination);
+          } else {
+            ok = setEdgeWeight(expected, mutations[i].source, mutations[i].destination, mutations[i].weight);
+          }
+          applied += ok ? 1 : 0;
+        }
+
+        assert(applyEdgeMutations(actual, mutations, 4000, parallel) == applied);
+        assert(sameGraph(expected, actual) == true);
+      }
+
+      assert(removeVertices(actual, vertices, 5) == 3);
+      removeVertex(expected, 199);
+      removeVertex(expected, 40);
+      removeVertex(expected, 3);
+      assert(sameGraph(expected, actual) == true);
+
+      setNumberOfThreads(1);
+      destroyGraph(expected);
+      destroyGraph(actual);
+    }
+  }
+}
+
+void dynamicSSSPTest() {
+  dynamicSSSP *d = NULL;
+  visitInfo *expected = NULL;
+  graph *g = NULL;
+  unsigned int seed = 23;
+  int source;
+  int destination;
+  int weight;
+
+  for(int directed = 0; directed < 2; directed++) {
+    g = initializeGraph(directed);
+    addVertex(g, 300);
+    for(int i = 0; i < 900; i++) {
+      seed = seed * 1103515245 + 12345;
+      addEdgeWeight(g, (seed >> 8) % 300, (seed >> 20) % 300, (seed >> 4) % 50);
+    }
+
+    d = initializeDynamicSSSP(g, 0);
+    for(int i = 0; i < 600; i++) {
+      seed = seed * 1103515245 + 12345;
+      source = (seed >> 8) % 300;
+      destination = (seed >> 20) % 300;
+      weight = (seed >> 4) % 50;
+      if(i % 3 == 0) {
+        dynamicAddEdge(d, source, destination, weight);
+      } else if(i % 3 == 1) {
+        for(edgenode *adj = g->adjList[source]; adj != NULL; adj = adj->next) {
+          destination = adj->edge;
+        }
+        dynamicRemoveEdge(d, source, destination);
+      } else {
+        if(g->adjList[source] != NULL) {
+          destination = g->adjList[source]->edge;
+        }
+        dynamicSetEdgeWeight(d, source, destination, weight);
+      }
+
+      if(i % 20 == 0) {
+        expected = getDijkstraShortestPaths(g, 0);
+        for(int v = 0; v < g->size; v++) {
+          assert(d->visit->distance[v] == expected->distance[v]);
+          if(d->visit->parent[v] != -1) {
+            assert(d->visit->distance[v] == d->visit->distance[d->visit->parent[v]] + getEdgeWeight(g, d->visit->parent[v], v));
+          }
+        }
+        destroyVisit(expected);
+      }
+    }
+
+    assert(dynamicAddEdge(d, 0, 1, -1) == false);
+    assert(dynamicRemoveEdge(d, 0, 300) == false);
+
+    // The vertices added after the initialization are unreachable until an edge reaches them
+    addVertex(g, 2);
+    assert(dynamicAddEdge(d, 300, 301, 4) == true);
+    assert(d->visit->distance[300] == MAX_DISTANCE && d->visit->distance[301] == MAX_DISTANCE);
+    assert(dynamicAddEdge(d, 0, 300, 3) == true);
+    assert(d->visit->distance[300] == 3 && d->visit->distance[301] == 7);
+    assert(d->visit->parent[301] == 300);
+    destroyDynamicSSSP(d);
+    destroyGraph(g);
+  }
+}
+
+void dynamicConnectivityTest() {
+  graph *g = initializeGraph(false);
+  graph *directed = initializeGraph(true);
+  lists *expected = NULL;
+  lists *actual = NULL;
+  visitInfo *visit = NULL;
+  unsigned int seed = 29;
+  int a;
+  int b;
+
+  assert(enableDynamicConnectivity(directed) == false);
+  destroyGraph(directed);
+
+  addVertex(g, 100);
+  assert(enableDynamicConnectivity(g) == true);
+  assert(getNumberOfComponents(g) == 100);
+
+  for(int i = 0; i < 3000; i++) {
+    seed = seed * 1103515245 + 12345;
+    a = (seed >> 8) % g->size;
+    b = (seed >> 20) % g->size;
+    if(i % 500 == 499) {
+      setLazyVertexRemoval(g, i % 1000 == 999);
+      removeVertex(g, a);
+      addVertex(g, 1);
+    } else if(i % 5 < 3) {
+      addEdge(g, a, b);
+    } else {
+      removeEdge(g, a, g->adjList[a] != NULL ? g->adjList[a]->edge : b);
+    }
+
+    if(i % 50 == 0) {
+      expected = getParallelConnectedComponents(g);
+      actual = getConnectedComponents(g);
+      assert(getNumberOfComponents(g) == expected->size);
+      assert(isConnected(g) == (expected->size == 1));
+      assert(sameLists(expected, actual) == true);
+      if(containsVertex(g, b)) {
+        visit = getBFS(g, b);
+        for(int v = 0; v < g->size; v++) {
+          assert(sameComponent(g, b, v) == (visit->color[v] == BLACK && containsVertex(g, v)));
+        }
+        destroyVisit(visit);
+      }
+      destroyLists(expected);
+      destroyLists(actual);
+    }
+  }
+
+  destroyGraph(g);
+}
+
+void graphStatsTest() {
+  graph *g = prepareDirectedGraphTest();
+  graphStats stats;
+
+  resetGraphStats();
+  destroyVisit(getBFS(g, 0));
+  stats = getGraphStats();
+#ifdef GRAPH_STATS
+  assert(stats.verticesSettled == 6);
+  assert(stats.edgesScanned == 9);
+  /* the visit information and the array used as queue */
+  assert(stats.allocations == 2);
+  assert(stats.phaseTime[STATS_SEARCH] > 0);
+#else
+  assert(stats.verticesSettled == 0);
+  assert(stats.edgesScanned == 0);
+  assert(stats.allocations == 0);
+#endif
+
+  resetGraphStats();
+  destroyVisit(getDijkstraShortestPaths(g, 0));
+  stats = getGraphStats();
+#ifdef GRAPH_STATS
+  assert(stats.verticesSettled == 6);
+  assert(stats.edgesScanned == 9);
+  assert(stats.relaxations >= 5);
+  assert(stats.heapOperations == 12 + stats.relaxations);
+#else
+  assert(stats.heapOperations == 0);
+  assert(stats.relaxations == 0);
+#endif
+
+  destroyGraph(g);
+}
+
+void reorderGraphTest() {
+  graph *g = NULL;
+  graph *path = initializeGraph(false);
+  vertexMap *map = NULL;
+  visitInfo *expected = NULL;
+  visitInfo *actual = NULL;
+  visitInfo *translated = NULL;
+  edgenode *adj = NULL;
+  int label[200];
+  int source;
+
+  for(int ordering = RCM_ORDER; ordering <= BFS_ORDER; ordering++) {
+    g = prepareRandomUndirectedGraph(300, 2, 31);
+    source = 17;
+    expected = getDijkstraShortestPaths(g, source);
+
+    map = reorderGraph(g, (enum vertexOrdering) ordering);
+    for(int v = 0; v < g->size; v++) {
+      assert(map->oldId[map->newId[v]] == v);
+    }
+    actual = getDijkstraShortestPaths(g, map->newId[source]);
+    translated = translateVisit(actual, map);
+    for(int v = 0; v < g->size; v++) {
+      assert(translated->distance[v] == expected->distance[v]);
+      if(translated->parent[v] != -1) {
+        assert(containsEdge(g, map->newId[translated->parent[v]], map->newId[v]) == true);
+      }
+    }
+
+    destroyVisit(expected);
+    destroyVisit(actual);
+    destroyVisit(translated);
+    destroyVertexMap(map);
+    destroyGraph(g);
+  }
+
+  addVertex(path, 200);
+  for(int i = 0; i < 200; i++) {
+    label[i] = (i * 77) % 200;
+  }
+  for(int i = 0; i + 1 < 200; i++) {
+    addEdge(path, label[i], label[i+1]);
+  }
+  map = reorderGraph(path, RCM_ORDER);
+  for(int v = 0; v < path->size; v++) {
+    for(adj = path->adjList[v]; adj != NULL; adj = adj->next) {
+      assert(abs(adj->edge - v) == 1);
+    }
+  }
+  destroyVertexMap(map);
+
+  map = reorderGraph(path, DEGREE_ORDER);
+  assert(path->adjList[199]->next == NULL);
+  assert(path->adjList[0]->next != NULL);
+  destroyVertexMap(map);
+  destroyGraph(path);
+}
+
+void compressedGraphTest() {
+  graph *g = prepareRandomUndirectedGraph(500, 3, 43);
+  graph *sorted = initializeGraph(true);
+  graph *sparse = initializeGraph(true);
+  compressedGraph *c = compressGraph(g);
+  compressedIterator it;
+  visitInfo *expected = NULL;
+  visitInfo *actual = NULL;
+  lists *expectedComponents = NULL;
+  lists *actualComponents = NULL;
+  edgenode *adj = NULL;
+  int neighbours[500];
+  int degree;
+  int neighbour;
+  int weight;
+  size_t listBytes = 0;
+
+  /* the neighbours are decoded in increasing order with their weights */
+  addVertex(sorted, g->size);
+  for(int v = 0; v < g->size; v++) {
+    degree = 0;
+    compressedBegin(c, v, &it);
+    while(compressedNext(&it, &neighbour, &weight)) {
+      assert(containsEdge(g, v, neighbour) == true);
+      /* an undirected self-loop is in the list twice, only the first copy has the weight */
+      assert(neighbour == v || getEdgeWeight(g, v, neighbour) == weight);
+      assert(degree == 0 || neighbours[degree-1] <= neighbour);
+      neighbours[degree++] = neighbour;
+    }
+    for(adj = g->adjList[v]; adj != NULL; adj = adj->next) {
+      degree -= 1;
+      listBytes += sizeof(edgenode);
+    }
+    assert(degree == 0);
+    assert(getCompressedDegree(c, v) == (int) (c->edgeOffset[v+1] - c->edgeOffset[v]));
+
+    /* edges are added at the head of the lists, so sorted visits the neighbours in increasing order */
+    degree = getCompressedDegree(c, v);
+    for(int i = degree - 1; i >= 0; i--) {
+      addEdgeWeight(sorted, v, neighbours[i], getEdgeWeight(g, v, neighbours[i]));
+    }
+  }
+  assert(getCompressedGraphBytes(c) < listBytes);
+
+  expected = getBFS(sorted, 7);
+  actual = getCompressedBFS(c, 7);
+  for(int v = 0; v < g->size; v++) {
+    assert(actual->startTime[v] == expected->startTime[v]);
+    assert(actual->endTime[v] == expected->endTime[v]);
+    assert(actual->parent[v] == expected->parent[v]);
+    assert(actual->color[v] == expected->color[v]);
+    if(actual->parent[v] != -1) {
+      assert(actual->distance[v] == actual->distance[actual->parent[v]] + 1);
+    }
+  }
+  destroyVisit(expected);
+  destroyVisit(actual);
+
+  expected = getDFS(sorted, 7);
+  actual = getCompressedDFS(c, 7);
+  for(int v = 0; v < g->size; v++) {
+    assert(actual->startTime[v] == expected->startTime[v]);
+    assert(actual->endTime[v] == expected->endTime[v]);
+    assert(actual->parent[v] == expected->parent[v]);
+    assert(actual->color[v] == expected->color[v]);
+  }
+  destroyVisit(expected);
+  destroyVisit(actual);
+
+  expectedComponents = getConnectedComponents(g);
+  actualComponents = getCompressedConnectedComponents(c);
+  assert(sameLists(expectedComponents, actualComponents) == true);
+  destroyLists(expectedComponents);
+  destroyLists(actualComponents);
+  destroyCompressedGraph(c);
+
+  /* long gaps need several bytes and the first neighbour can be smaller than the vertex */
+  addVertex(sparse, 70000);
+  addEdgeWeight(sparse, 69999, 1, -5);
+  addEdge(sparse, 69999, 69998);
+  addEdge(sparse, 0, 69999);
+  addEdge(sparse, 0, 200);
+  c = compressGraph(sparse);
+  assert(getCompressedConnectedComponents(c) == NULL);
+  compressedBegin(c, 69999, &it);
+  assert(compressedNext(&it, &neighbour, &weight) == true && neighbour == 1 && weight == -5);
+  assert(compressedNext(&it, &neighbour, &weight) == true && neighbour == 69998 && weight == DEFAULT_EDGE_WEIGHT);
+  assert(compressedNext(&it, &neighbour, &weight) == false);
+  actual = getCompressedDFS(c, 0);
+  assert(actual->parent[69999] == 0 && actual->parent[1] == 69999 && actual->parent[200] == 0);
+  assert(actual->startTime[200] == 1 && actual->endTime[0] == 9);
+  destroyVisit(actual);
+  destroyCompressedGraph(c);
+
+  destroyGraph(g);
+  destroyGraph(sorted);
+  destroyGraph(sparse);
+}
+
+void neighbourIterationTest() {
+  graph *g = NULL;
+  csrGraph *csr = NULL;
+  compressedGraph *compressed = NULL;
+  visitInfo *expected = NULL;
+  visitInfo *actual[3];
+  lists *expectedComponents = NULL;
+  lists *actualComponents = NULL;
+  listIterator listIt;
+  csrIterator csrIt;
+  edgenode *adj = NULL;
+  int neighbour;
+  int weight;
+
+  for(int t = 0; t < 2; t++) {
+    g = t == 0 ? prepareDirectedGraphTest() : prepareRandomUndirectedGraph(400, 2, 47);
+    csr = getCSRGraph(g);
+    compressed = compressGraph(g);
+
+    /* the list and CSR iterators follow the adjacency lists */
+    for(int v = 0; v < g->size; v++) {
+      adj = g->adjList[v];
+      listBegin(g, v, &listIt);
+      csrBegin(csr, v, &csrIt);
+      while(listNext(&listIt, &neighbour, &weight)) {
+        assert(adj != NULL && adj->edge == neighbour && adj->weight == weight);
+        assert(csrNext(&csrIt, &neighbour, &weight) == true);
+        assert(adj->edge == neighbour && adj->weight == weight);
+        adj = adj->next;
+      }
+      assert(adj == NULL);
+      assert(csrNext(&csrIt, &neighbour, &weight) == false);
+    }
+
+    expected = getBFS(g, 0);
+    actual[0] = getCSRBFS(csr, 0);
+    for(int v = 0; v < g->size; v++) {
+      assert(actual[0]->startTime[v] == expected->startTime[v]);
+      assert(actual[0]->endTime[v] == expected->endTime[v]);
+      assert(actual[0]->parent[v] == expected->parent[v]);
+    }
+    destroyVisit(expected);
+    destroyVisit(actual[0]);
+
+    expected = getDFS(g, 0);
+    actual[0] = getCSRDFS(csr, 0);
+    for(int v = 0; v < g->size; v++) {
+      assert(actual[0]->startTime[v] == expected->startTime[v]);
+      assert(actual[0]->endTime[v] == expected->endTime[v]);
+      assert(actual[0]->parent[v] == expected->parent[v]);
+    }
+    destroyVisit(expected);
+    destroyVisit(actual[0]);
+
+    expected = getDijkstraShortestPaths(g, 0);
+    actual[0] = getListDijkstraShortestPaths(g, 0);
+    actual[1] = getCSRDijkstraShortestPaths(csr, 0);
+    actual[2] = getCompressedDijkstraShortestPaths(compressed, 0);
+    for(int i = 0; i < 3; i++) {
+      for(int v = 0; v < g->size; v++) {
+        assert(actual[i]->distance[v] == expected->distance[v]);
+      }
+      destroyVisit(actual[i]);
+    }
+    destroyVisit(expected);
+    assert(getCSRBFS(csr, g->size) == NULL);
+
+    if(!g->directed) {
+      expectedComponents = getConnectedComponents(g);
+      actualComponents = getListConnectedComponents(g);
+      assert(sameLists(expectedComponents, actualComponents) == true);
+      destroyLists(actualComponents);
+      actualComponents = getCSRConnectedComponents(csr);
+      assert(sameLists(expectedComponents, actualComponents) == true);
+      destroyLists(actualComponents);
+      destroyLists(expectedComponents);
+    } else {
+      assert(getCSRConnectedComponents(csr) == NULL);
+    }
+
+    destroyCSRGraph(csr);
+    destroyCompressedGraph(compressed);
+    destroyGraph(g);
+  }
+
+  g = prepareDirectedGraphTest();
+  setEdgeWeight(g, 0, 1, -1);
+  csr = getCSRGraph(g);
+  assert(getCSRDijkstraShortestPaths(csr, 0) == NULL);
+  assert(getListDijkstraShortestPaths(g, 0) == NULL);
+  destroyCSRGraph(csr);
+  destroyGraph(g);
+}
+
+bool validReverseIndex(graph *g) {
+  edgenode *adj = NULL;
+  edgenode *in = NULL;
+  int nedges = 0;
+
+  if(g->inAdjList == NULL) return false;
+  for(int v = 0; v < g->size; v++) {
+    for(adj = g->adjList[v]; adj != NULL; adj = adj->next) {
+      in = g->inAdjList[adj->edge];
+      while(in != NULL && (in->edge != v || in->weight != adj->weight)) {
+        in = in->next;
+      }
+      if(in == NULL) return false;
+      nedges += 1;
+    }
+    for(in = g->inAdjList[v]; in != NULL; in = in->next) {
+      nedges -= 1;
+    }
+  }
+
+  return nedges == 0;
+}
+
+void reverseIndexTest() {
+  graph *g = initializeGraph(true);
+  graph *plain = initializeGraph(true);
+  graph *view = NULL;
+  graph *copy = NULL;
+  edgeMutation mutations[600];
+  visitInfo *backward = NULL;
+  visitInfo *forward = NULL;
+  lists *expected = NULL;
+  lists *actual = NULL;
+  dynamicSSSP *d = NULL;
+  listIterator it;
+  unsigned int seed = 23;
+  int vertices[] = {5, 17, 5};
+  int source;
+  int destination;
+  int neighbour;
+  int weight;
+  int degree;
+
+  addVertex(g, 100);
+  addVertex(plain, 100);
+  assert(enableReverseIndex(g) == true);
+  for(int i = 0; i < 400; i++) {
+    seed = seed * 1103515245 + 12345;
+    source = (seed >> 8) % 100;
+    seed = seed * 1103515245 + 12345;
+    destination = (seed >> 8) % 100;
+    addEdgeWeight(g, source, destination, (seed >> 16) % 50);
+    addEdgeWeight(plain, source, destination, (seed >> 16) % 50);
+    if(i % 4 == 0) {
+      setEdgeWeight(g, source, destination, i % 7);
+      setEdgeWeight(plain, source, destination, i % 7);
+    } else if(i % 9 == 0) {
+      removeEdge(g, source, destination);
+      removeEdge(plain, source, destination);
+    }
+  }
+  assert(validReverseIndex(g) == true);
+
+  /* the batch changes the incoming lists as the mirror halves of the mutations */
+  for(int i = 0; i < 600; i++) {
+    seed = seed * 1103515245 + 12345;
+    mutations[i].type = (enum mutationType) (i % 3);
+    mutations[i].source = (seed >> 8) % 100;
+    seed = seed * 1103515245 + 12345;
+    mutations[i].destination = (seed >> 8) % 100;
+    mutations[i].weight = (seed >> 16) % 50;
+  }
+  setNumberOfThreads(4);
+  assert(applyEdgeMutations(g, mutations, 600, true) == applyEdgeMutations(plain, mutations, 600, false));
+  setNumberOfThreads(1);
+  assert(validReverseIndex(g) == true);
+  assert(sameGraph(g, plain) == true);
+
+  for(int v = 0; v < g->size; v++) {
+    degree = 0;
+    incomingBegin(g, v, &it);
+    while(listNext(&it, &neighbour, &weight)) {
+      assert(getEdgeWeight(g, neighbour, v) == weight);
+      degree += 1;
+    }
+    for(int u = 0; u < g->size; u++) {
+      degree -= containsEdge(g, u, v) ? 1 : 0;
+    }
+    assert(degree == 0);
+  }
+
+  /* the view shares the lists: backward Dijkstra from 0 gives the distances to 0 */
+  view = getTransposedGraph(g);
+  assert(view->view == true && view->adjList == g->inAdjList);
+  backward = getDijkstraShortestPaths(view, 0);
+  for(int v = 0; v < g->size; v += 7) {
+    forward = getDijkstraShortestPaths(g, v);
+    assert(forward->distance[0] == backward->distance[v]);
+    destroyVisit(forward);
+  }
+  destroyVisit(backward);
+  expected = getStronglyConnectedComponents(g);
+  disableReverseIndex(g);
+  actual = getStronglyConnectedComponents(g);
+  assert(sameLists(expected, actual) == true);
+  destroyLists(expected);
+  destroyLists(actual);
+  destroyGraph(view);
+
+  copy = getTransposedGraph(g);
+  assert(copy->view == false && getIncomingEdges(g, 0) == NULL);
+  enableReverseIndex(g);
+  view = getTransposedGraph(g);
+  assert(sameGraph(view, copy) == true);
+  destroyGraph(view);
+  destroyGraph(copy);
+
+  setLazyVertexRemoval(g, true);
+  removeVertex(g, 3);
+  assert(validReverseIndex(g) == true && getIncomingEdges(g, 3) == NULL);
+  setLazyVertexRemoval(g, false);
+  removeVertex(g, 10);
+  assert(validReverseIndex(g) == true);
+  setLazyVertexRemoval(g, true);
+  removeVertices(g, vertices, 3);
+  assert(validReverseIndex(g) == true);
+  free(compactGraph(g));
+  assert(g->size == 96 && validReverseIndex(g) == true);
+  addVertex(g, 4);
+  addEdgeWeight(g, 99, 0, 3);
+  addEdgeWeight(g, 0, 98, 4);
+  destroyVertexMap(reorderGraph(g, RCM_ORDER));
+  assert(validReverseIndex(g) == true);
+
+  /* the dynamic shortest paths use the index and disable it only if they enabled it */
+  d = initializeDynamicSSSP(g, 0);
+  destroyDynamicSSSP(d);
+  assert(g->inAdjList != NULL);
+  d = initializeDynamicSSSP(plain, 0);
+  assert(plain->inAdjList != NULL);
+  dynamicAddEdge(d, 1, 2, 5);
+  dynamicRemoveEdge(d, 1, 2);
+  assert(validReverseIndex(plain) == true);
+  destroyDynamicSSSP(d);
+  assert(plain->inAdjList == NULL);
+
+  destroyGraph(g);
+  destroyGraph(plain);
+
+  g = prepareUndirectedGraphTest();
+  assert(enableReverseIndex(g) == false);
+  assert(getIncomingEdges(g, 0) == g->adjList[0]);
+  destroyGraph(g);
+}
+
+typedef struct readerTask readerTask;
+
+struct readerTask {
+  concurrentGraph *cg;
+  int *expected;
+  int reads;
+};
+
+void * concurrentReader(void *arg) {
+  readerTask *task = (readerTask *) arg;
+  graphSnapshot *snapshot = NULL;
+  visitInfo *visit = NULL;
+
+  for(int i = 0; i < task->reads; i++) {
+    snapshot = acquireSnapshot(task->cg);
+    assert(getNumberOfEdges(&snapshot->g) == task->expected[snapshot->version]);
+    visit = getBFS(&snapshot->g, i % snapshot->g.size);
+    destroyVisit(visit);
+    visit = getDijkstraShortestPaths(&snapshot->g, i % snapshot->g.size);
+    assert(visit != NULL);
+    destroyVisit(visit);
+    assert(getNumberOfEdges(&snapshot->g) == task->expected[snapshot->version]);
+    releaseSnapshot(task->cg, snapshot);
+  }
+
+  return NULL;
+}
+
+void concurrentGraphTest() {
+  graph *g = prepareRandomUndirectedGraph(200, 2, 53);
+  concurrentGraph *cg = NULL;
+  graphSnapshot *first = NULL;
+  graphSnapshot *second = NULL;
+  pthread_t readers[3];
+  readerTask task;
+  int expected[101];
+  unsigned int seed = 59;
+  int totalWeight;
+  int nedges;
+  int source;
+  int destination;
+
+  /* the two copies of an undirected self-loop have different weights, sameGraph can't compare them */
+  for(int v = 0; v < g->size; v++) {
+    removeEdge(g, v, v);
+  }
+  totalWeight = getTotalWeight(g);
+  nedges = getNumberOfEdges(g);
+  cg = initializeConcurrentGraph(g);
+  first = acquireSnapshot(cg);
+  assert(first->version == 0 && sameGraph(&first->g, g) == true);
+
+  /* the changes are applied to g too, the first snapshot doesn't see them */
+  for(int v = 0; v < 200; v += 3) {
+    destination = g->adjList[v]->edge;
+    if(v % 2 == 0) {
+      assert(concurrentRemoveEdge(cg, v, destination) == true);
+      removeEdge(g, v, destination);
+    } else {
+      assert(concurrentSetEdgeWeight(cg, v, destination, 1000 + v) == true);
+      setEdgeWeight(g, v, destination, 1000 + v);
+    }
+  }
+  assert(concurrentAddVertex(cg, 2) == true);
+  addVertex(g, 2);
+  assert(concurrentAddEdge(cg, 200, 201, 7) == true);
+  assert(concurrentAddEdge(cg, 200, 201, 7) == false);
+  addEdgeWeight(g, 200, 201, 7);
+  assert(concurrentRemoveEdge(cg, 200, 5) == false);
+
+  second = acquireSnapshot(cg);
+  assert(second == first);
+  releaseSnapshot(cg, second);
+  assert(publishSnapshot(cg) == 1);
+  second = acquireSnapshot(cg);
+  assert(second->version == 1 && sameGraph(&second->g, g) == true);
+  assert(first->g.size == 200 && getNumberOfEdges(&first->g) == nedges && getTotalWeight(&first->g) == totalWeight);
+  releaseSnapshot(cg, first);
+  releaseSnapshot(cg, second);
+  destroyConcurrentGraph(cg);
+  destroyGraph(g);
+
+  /* the tombstones of a lazy removal stay removed in the private graph and in the snapshots */
+  g = prepareRandomUndirectedGraph(50, 2, 67);
+  g->lazyRemoval = true;
+  removeVertex(g, 10);
+  cg = initializeConcurrentGraph(g);
+  first = acquireSnapshot(cg);
+  assert(containsVertex(&first->g, 10) == false && first->g.removedCount == 1);
+  assert(concurrentAddEdge(cg, 10, 11, 1) == false);
+  assert(concurrentAddVertex(cg, 1) == true);
+  assert(publishSnapshot(cg) == 1);
+  second = acquireSnapshot(cg);
+  assert(containsVertex(&second->g, 10) == false && containsVertex(&second->g, 50) == true);
+  assert(containsVertex(&first->g, 10) == false);
+  releaseSnapshot(cg, first);
+  releaseSnapshot(cg, second);
+  destroyConcurrentGraph(cg);
+  destroyGraph(g);
+
+  /* the readers check that every snapshot is consistent while the writer publishes 100 versions */
+  g = prepareRandomUndirectedGraph(300, 2, 61);
+  cg = initializeConcurrentGraph(g);
+  expected[0] = getNumberOfEdges(g);
+  task.cg = cg;
+  task.expected = expected;
+  task.reads = 60;
+  for(int i = 0; i < 3; i++) {
+    pthread_create(&readers[i], NULL, concurrentReader, &task);
+  }
+  for(int version = 1; version <= 100; version++) {
+    for(int i = 0; i < 10; i++) {
+      seed = seed * 1103515245 + 12345;
+      source = (seed >> 8) % 300;
+      seed = seed * 1103515245 + 12345;
+      destination = (seed >> 8) % 300;
+      if(source == destination) continue;
+      if(!concurrentRemoveEdge(cg, source, destination)) {
+        concurrentAddEdge(cg, source, destination, (seed >> 16) % 100);
+      }
+      concurrentSetEdgeWeight(cg, destination, (destination + 1) % 300, i);
+    }
+    expected[version] = getNumberOfEdges(cg->g);
+    assert(publishSnapshot(cg) == version);
+  }
+  for(int i = 0; i < 3; i++) {
+    pthread_join(readers[i], NULL);
+  }
+
+  destroyConcurrentGraph(cg);
+  destroyGraph(g);
+}
+
+typedef struct poolTask poolTask;
+
+struct poolTask {
+  atomic_int *count;
+  atomic_int calls;
+  int grain;
+};
+
+void countChunk(int start, int end, void *arg) {
+  poolTask *task = (poolTask *) arg;
+
+  assert(getNumberOfThreads() == 1 || end - start <= task->grain);
+  assert(getWorkerId() >= 0 && getWorkerId() < getNumberOfThreads());
+  atomic_fetch_add(&task->calls, 1);
+  for(int i = start; i < end; i++) {
+    atomic_fetch_add(&task->count[i], 1);
+  }
+}
+
+void nestedChunk(int start, int end, void *arg) {
+  poolTask *task = (poolTask *) arg;
+
+  for(int i = start; i < end; i++) {
+    parallelForGrain(i * 100, (i+1) * 100, 7, countChunk, task);
+  }
+}
+
+void bufferChunk(int start, int end, void *arg) {
+  workerBuffers *buffers = (workerBuffers *) arg;
+  int *counts = (int *) acquireWorkerBuffer(buffers);
+  int *nested = (int *) acquireWorkerBuffer(buffers);
+
+  assert(counts != nested);
+  for(int i = start; i < end; i++) {
+    counts[i % 100] += 1;
+    nested[i % 100] += 2;
+  }
+  releaseWorkerBuffer(buffers, nested);
+  releaseWorkerBuffer(buffers, counts);
+}
+
+void threadPoolTest() {
+  poolTask task;
+  atomic_int *count = (atomic_int *) malloc(sizeof(atomic_int) * 100000);
+  workerBuffers *buffers = NULL;
+  void **partial = NULL;
+  int npartial;
+  int sum;
+
+  task.count = count;
+  for(int threads = 1; threads <= 4; threads *= 2) {
+    setNumberOfThreads(threads);
+    for(int i = 0; i < 100000; i++) {
+      atomic_init(&count[i], 0);
+    }
+
+    /* every index is run exactly once, in chunks not bigger than the grain */
+    task.grain = 10;
+    atomic_init(&task.calls, 0);
+    parallelForGrain(0, 100000, task.grain, countChunk, &task);
+    assert(threads == 1 ? atomic_load(&task.calls) == 1 : atomic_load(&task.calls) >= 10000);
+
+    /* the tasks of a nested call run on the same workers */
+    task.grain = 7;
+    parallelForGrain(0, 1000, 1, nestedChunk, &task);
+    for(int i = 0; i < 100000; i++) {
+      assert(atomic_load(&count[i]) == 2);
+    }
+
+    task.grain = 100000;
+    atomic_init(&task.calls, 0);
+    parallelFor(0, 100000, countChunk, &task);
+    parallelFor(5, 5, countChunk, &task);
+    assert(atomic_load(&task.calls) >= 1 && atomic_load(&task.calls) <= 4 * threads);
+
+    /* a buffer for each thread, plus the extra ones taken while a thread already holds its own */
+    buffers = initializeWorkerBuffers(sizeof(int) * 100);
+    parallelForGrain(0, 100000, 10, bufferChunk, buffers);
+    partial = getWorkerBuffers(buffers, &npartial);
+    assert(npartial >= 2 && npartial <= 2 * threads);
+    for(int i = 0; i < 100; i++) {
+      sum = 0;
+      for(int j = 0; j < npartial; j++) {
+        sum += ((int *) partial[j])[i];
+      }
+      assert(sum == 3000);
+    }
+    free(partial);
+    destroyWorkerBuffers(buffers);
+  }
+
+  setNumberOfThreads(1);
+  free(count);
+}
+
+void queryBatchTest() {
+  graph *g = prepareRandomUndirectedGraph(300, 2, 67);
+  graphQuery queries[400];
+  visitInfo *expected = NULL;
+  int answered;
+
+  for(int threads = 1; threads <= 4; threads *= 4) {
+    setNumberOfThreads(threads);
+    for(int i = 0; i < 400; i++) {
+      queries[i].type = i % 2 == 0 ? BFS_QUERY : DIJKSTRA_QUERY;
+      queries[i].source = (i * 37) % 300;
+      queries[i].target = i % 4 < 2 ? -1 : (i * 91) % 300;
+    }
+    queries[5].source = 300;
+    queries[6].target = -2;
+
+    answered = runQueryBatch(g, queries, 400);
+    assert(answered == 398 && queries[5].done == false && queries[6].done == false);
+    for(int i = 0; i < 400; i++) {
+      if(!queries[i].done) continue;
+
+      expected = queries[i].type == BFS_QUERY ? getBFS(g, queries[i].source) : getDijkstraShortestPaths(g, queries[i].source);
+      if(queries[i].target != -1) {
+        assert(queries[i].visit == NULL);
+        assert(queries[i].distance == expected->distance[queries[i].target]);
+      } else {
+        for(int v = 0; v < g->size; v++) {
+          assert(queries[i].visit->distance[v] == expected->distance[v]);
+          if(queries[i].type == BFS_QUERY) {
+            assert(queries[i].visit->parent[v] == expected->parent[v]);
+            assert(queries[i].visit->startTime[v] == expected->startTime[v]);
+            assert(queries[i].visit->endTime[v] == expected->endTime[v]);
+          }
+        }
+        destroyVisit(queries[i].visit);
+      }
+      destroyVisit(expected);
+    }
+  }
+  setNumberOfThreads(1);
+
+  setEdgeWeight(g, 0, 1, -3);
+  queries[0].type = DIJKSTRA_QUERY;
+  queries[0].source = 0;
+  queries[0].target = -1;
+  queries[1].type = BFS_QUERY;
+  queries[1].source = 0;
+  queries[1].target = 0;
+  assert(runQueryBatch(g, queries, 2) == 1);
+  assert(queries[0].done == false && queries[0].visit == NULL);
+  assert(queries[1].done == true && queries[1].distance == 0);
+
+  destroyGraph(g);
+}
+
+void multiSourceBFSTest() {
+  graph *g = NULL;
+  visitInfo *expected = NULL;
+  int **distance = NULL;
+  bfsSummary *summary = NULL;
+  int sources[5] = {3, 0, 3, 6, 5};
+  long long sum;
+  int reached, eccentricity;
+
+  for(int t = 0; t < 2; t++) {
+    g = t == 0 ? prepareDirectedGraphTest() : prepareRandomUndirectedGraph(200, 2, 71);
+    if(t == 1) {
+      setLazyVertexRemoval(g, true);
+      removeVertex(g, 17);
+    }
+
+    for(int threads = 1; threads <= 4; threads *= 4) {
+      setNumberOfThreads(threads);
+      distance = getMultiSourceBFS(g, NULL, 0);
+      summary = getMultiSourceBFSSummary(g, NULL, 0);
+      for(int s = 0; s < g->size; s++) {
+        if(!containsVertex(g, s)) {
+          for(int v = 0; v < g->size; v++) {
+            assert(distance[s][v] == MAX_DISTANCE);
+          }
+          assert(summary[s].reached == 0 && summary[s].distanceSum == 0);
+          free(distance[s]);
+          continue;
+        }
+
+        expected = getBFS(g, s);
+        sum = 0;
+        reached = 0;
+        eccentricity = 0;
+        for(int v = 0; v < g->size; v++) {
+          assert(distance[s][v] == expected->distance[v]);
+          if(expected->distance[v] == MAX_DISTANCE) continue;
+          sum += expected->distance[v];
+          reached += 1;
+          if(expected->distance[v] > eccentricity) eccentricity = expected->distance[v];
+        }
+        assert(summary[s].distanceSum == sum && summary[s].reached == reached);
+        assert(summary[s].eccentricity == eccentricity);
+        destroyVisit(expected);
+        free(distance[s]);
+      }
+      free(distance);
+      free(summary);
+    }
+    setNumberOfThreads(1);
+
+    // Repeated sources and sources that don't exist
+    sources[3] = t == 0 ? 6 : 17;
+    distance = getMultiSourceBFS(g, sources, 5);
+    for(int i = 0; i < 5; i++) {
+      if(containsVertex(g, sources[i])) {
+        expected = getBFS(g, sources[i]);
+        for(int v = 0; v < g->size; v++) {
+          assert(distance[i][v] == expected->distance[v]);
+        }
+        destroyVisit(expected);
+      } else {
+        assert(distance[i][0] == MAX_DISTANCE);
+      }
+      free(distance[i]);
+    }
+    free(distance);
+
+    destroyGraph(g);
+  }
+}
+
+bool closeTo(double a, double b, double epsilon) {
+  return a - b < epsilon && b - a < epsilon;
+}
+
+void centralityTest() {
+  int n = 40;
+  int distance[40][40];
+  double sigma[40][40];
+  double betweenness[40], closeness[40];
+  double *result = NULL;
+  double *other = NULL;
+  double total, expectedTotal;
+  unsigned int seed = 79;
+  int count, length, nvertices;
+  long long sum;
+  graph *g = NULL;
+
+  for(int t = 0; t < 4; t++) {
+    bool weighted = t % 2 == 1;
+
+    if(t % 2 == 0) {
+      g = initializeGraph(t == 0);
+      addVertex(g, n);
+      for(int i = 0; i < 3 * n; i++) {
+        seed = seed * 1103515245 + 12345;
+        int a = (seed >> 8) % n;
+        seed = seed * 1103515245 + 12345;
+        int b = (seed >> 8) % n;
+        if(a != b) addEdgeWeight(g, a, b, 1 + (seed >> 16) % 3);
+      }
+      setLazyVertexRemoval(g, true);
+      removeVertex(g, 7);
+      // The tombstone stays when the lazy removal is turned off
+      setLazyVertexRemoval(g, t == 0);
+    }
+    nvertices = n - 1;
+
+    // Reference: all pairs distances and shortest path counts
+    for(int i = 0; i < n; i++) {
+      for(int j = 0; j < n; j++) {
+        distance[i][j] = i == j ? 0 : MAX_DISTANCE;
+      }
+      for(edgenode *adj = getAdjacent(g, i); adj != NULL; adj = adj->next) {
+        distance[i][adj->edge] = weighted ? adj->weight : 1;
+      }
+    }
+    for(int k = 0; k < n; k++) {
+      for(int i = 0; i < n; i++) {
+        for(int j = 0; j < n; j++) {
+          if(distance[i][k] + distance[k][j] < distance[i][j]) distance[i][j] = distance[i][k] + distance[k][j];
+        }
+      }
+    }
+    for(int s = 0; s < n; s++) {
+      for(int d = 0; d < 3 * n; d++) {
+        for(int v = 0; v < n; v++) {
+          if(distance[s][v] != d) continue;
+          sigma[s][v] = v == s ? 1 : 0;
+          for(int u = 0; u < n; u++) {
+            for(edgenode *adj = getAdjacent(g, u); adj != NULL; adj = adj->next) {
+              length = weighted ? adj->weight : 1;
+              if(adj->edge == v && distance[s][u] + length == d) sigma[s][v] += sigma[s][u];
+            }
+          }
+        }
+      }
+    }
+    for(int v = 0; v < n; v++) {
+      betweenness[v] = 0;
+      closeness[v] = 0;
+      if(!containsVertex(g, v)) continue;
+      for(int s = 0; s < n; s++) {
+        for(int d = 0; d < n; d++) {
+          if(s == v || d == v || s == d || !containsVertex(g, s) || !containsVertex(g, d)) continue;
+          if(distance[s][d] != MAX_DISTANCE && distance[s][v] + distance[v][d] == distance[s][d]) {
+            betweenness[v] += sigma[s][v] * sigma[v][d] / sigma[s][d];
+          }
+        }
+      }
+      if(!g->directed) betweenness[v] /= 2;
+
+      count = 0;
+      sum = 0;
+      for(int d = 0; d < n; d++) {
+        if(d == v || distance[v][d] == MAX_DISTANCE) continue;
+        count += 1;
+        sum += distance[v][d];
+      }
+      if(count > 0) closeness[v] = (double) count * count / ((double) (nvertices - 1) * sum);
+    }
+
+    for(int threads = 1; threads <= 4; threads *= 4) {
+      setNumberOfThreads(threads);
+      result = getBetweennessCentrality(g, weighted, 0, 0);
+      for(int v = 0; v < n; v++) {
+        assert(closeTo(result[v], betweenness[v], 1e-9));
+      }
+      free(result);
+      result = getClosenessCentrality(g, weighted, nvertices, 0);
+      for(int v = 0; v < n; v++) {
+        assert(closeTo(result[v], closeness[v], 1e-9));
+      }
+      free(result);
+
+      // The sampling is deterministic for a given seed
+      result = getBetweennessCentrality(g, weighted, 10, 5);
+      other = getBetweennessCentrality(g, weighted, 10, 5);
+      for(int v = 0; v < n; v++) {
+        assert(result[v] >= 0 && closeTo(result[v], other[v], 1e-9));
+      }
+      free(result);
+      free(other);
+      result = getClosenessCentrality(g, weighted, 10, 5);
+      assert(result[7] == 0);
+      free(result);
+    }
+    setNumberOfThreads(1);
+
+    if(t % 2 == 1) destroyGraph(g);
+  }
+
+  // On a cycle every source has the same total dependency, so the sampled total is exact
+  g = initializeGraph(false);
+  addVertex(g, 31);
+  for(int v = 0; v < 31; v++) {
+    addEdge(g, v, (v + 1) % 31);
+  }
+  result = getBetweennessCentrality(g, false, 0, 0);
+  other = getBetweennessCentrality(g, false, 6, 3);
+  total = 0;
+  expectedTotal = 0;
+  for(int v = 0; v < 31; v++) {
+    total += other[v];
+    expectedTotal += result[v];
+    assert(closeTo(result[v], result[0], 1e-9));
+  }
+  assert(closeTo(total, expectedTotal, 1e-6));
+  free(result);
+  free(other);
+
+  setEdgeWeight(g, 0, 1, -1);
+  assert(getBetweennessCentrality(g, true, 0, 0) == NULL);
+  assert(getClosenessCentrality(g, true, 0, 0) == NULL);
+  result = getClosenessCentrality(g, false, 0, 0);
+  assert(closeTo(result[0], 30.0 / 240, 1e-9));
+  free(result);
+
+  destroyGraph(g);
+}
+
+void pageRankTest() {
+  graph *g = initializeGraph(true);
+  double personalization[60];
+  double expected[60];
+  double *rank = NULL;
+  double *other = NULL;
+  double *push = NULL;
+  double total, dangling, jump;
+  unsigned int seed = 83;
+  int iterations, pushes, degree, nedges;
+
+  // On a cycle the rank is uniform
+  addVertex(g, 3);
+  addEdge(g, 0, 1);
+  addEdge(g, 1, 2);
+  addEdge(g, 2, 0);
+  rank = getPageRank(g, 0.85, 1e-12, 100, &iterations);
+  for(int v = 0; v < 3; v++) {
+    assert(closeTo(rank[v], 1.0 / 3, 1e-12));
+  }
+  assert(iterations == 1);
+  free(rank);
+  destroyGraph(g);
+
+  g = initializeGraph(true);
+  addVertex(g, 60);
+  for(int i = 0; i < 150; i++) {
+    seed = seed * 1103515245 + 12345;
+    int a = (seed >> 8) % 60;
+    seed = seed * 1103515245 + 12345;
+    int b = (seed >> 8) % 50;
+    addEdge(g, a, b);
+  }
+  setLazyVertexRemoval(g, true);
+  removeVertex(g, 3);
+  nedges = getNumberOfEdges(g);
+  for(int v = 0; v < 60; v++) {
+    personalization[v] = v % 3;
+  }
+
+  for(int t = 0; t < 2; t++) {
+    setNumberOfThreads(1);
+    rank = getPersonalizedPageRank(g, t == 0 ? NULL : personalization, 0.85, 1e-13, 1000, &iterations);
+    setNumberOfThreads(4);
+    other = getPersonalizedPageRank(g, t == 0 ? NULL : personalization, 0.85, 1e-13, 1000, NULL);
+    setNumberOfThreads(1);
+
+    // The result is a fixed point of the iteration
+    total = 0;
+    dangling = 0;
+    for(int v = 0; v < 60; v++) {
+      total += containsVertex(g, v) ? (t == 0 ? 1 : personalization[v]) : 0;
+      if(getAdjacent(g, v) == NULL) dangling += rank[v];
+    }
+    for(int v = 0; v < 60; v++) {
+      jump = containsVertex(g, v) ? (t == 0 ? 1 : personalization[v]) / total : 0;
+      expected[v] = (0.15 + 0.85 * dangling) * jump;
+    }
+    for(int v = 0; v < 60; v++) {
+      degree = 0;
+      for(edgenode *adj = getAdjacent(g, v); adj != NULL; adj = adj->next) degree += 1;
+      for(edgenode *adj = getAdjacent(g, v); adj != NULL; adj = adj->next) {
+        expected[adj->edge] += 0.85 * rank[v] / degree;
+      }
+    }
+    total = 0;
+    for(int v = 0; v < 60; v++) {
+      assert(closeTo(rank[v], expected[v], 1e-10));
+      assert(closeTo(rank[v], other[v], 1e-10));
+      total += rank[v];
+    }
+    assert(closeTo(total, 1, 1e-9) && rank[3] == 0 && iterations > 1 && iterations < 1000);
+    free(rank);
+    free(other);
+  }
+
+  // The push approximation is below the exact personalized rank by at most the residual left
+  for(int v = 0; v < 60; v++) {
+    personalization[v] = v == 5 ? 1 : 0;
+  }
+  rank = getPersonalizedPageRank(g, personalization, 0.85, 1e-14, 1000, NULL);
+  push = getPushPersonalizedPageRank(g, 5, 0.85, 1e-6, &pushes);
+  for(int v = 0; v < 60; v++) {
+    assert(push[v] <= rank[v] + 1e-12 && rank[v] - push[v] <= 1e-6 * (nedges + 60));
+  }
+  assert(pushes > 0);
+  free(rank);
+  free(push);
+
+  personalization[5] = -1;
+  assert(getPersonalizedPageRank(g, personalization, 0.85, 1e-6, 100, NULL) == NULL);
+  personalization[5] = 0;
+  personalization[3] = 1;
+  assert(getPersonalizedPageRank(g, personalization, 0.85, 1e-6, 100, NULL) == NULL);
+  assert(getPushPersonalizedPageRank(g, 3, 0.85, 1e-6, NULL) == NULL);
+
+  destroyGraph(g);
+}
+
+void triangleTest() {
+  graph *g = initializeGraph(false);
+  long long vertexTriangles[300];
+  long long expected[300];
+  long long triangles, paths;
+  double *coefficients = NULL;
+  int degree;
+
+  // Two triangles sharing the edge (0, 1), a pendant vertex and a self-loop
+  addVertex(g, 5);
+  addEdge(g, 0, 1);
+  addEdge(g, 1, 2);
+  addEdge(g, 2, 0);
+  addEdge(g, 0, 3);
+  addEdge(g, 3, 1);
+  addEdge(g, 3, 4);
+  addEdge(g, 2, 2);
+  assert(getTriangleCount(g, vertexTriangles) == 2);
+  assert(vertexTriangles[0] == 2 && vertexTriangles[1] == 2 && vertexTriangles[2] == 1 && vertexTriangles[3] == 1 && vertexTriangles[4] == 0);
+  coefficients = getClusteringCoefficients(g);
+  assert(closeTo(coefficients[0], 2.0 / 3, 1e-12) && closeTo(coefficients[2], 1, 1e-12));
+  assert(closeTo(coefficients[3], 1.0 / 3, 1e-12) && coefficients[4] == 0);
+  free(coefficients);
+  assert(closeTo(getTransitivity(g), 6.0 / 10, 1e-12));
+  destroyGraph(g);
+
+  // A hub makes the neighbour lists unbalanced, so both intersections are used
+  g = prepareRandomUndirectedGraph(300, 4, 89);
+  for(int v = 1; v < 300; v += 2) {
+    if(!containsEdge(g, 0, v)) addEdge(g, 0, v);
+  }
+  setLazyVertexRemoval(g, true);
+  removeVertex(g, 9);
+
+  triangles = 0;
+  paths = 0;
+  for(int v = 0; v < 300; v++) {
+    expected[v] = 0;
+  }
+  for(int a = 0; a < 300; a++) {
+    degree = 0;
+    for(edgenode *adj = getAdjacent(g, a); adj != NULL; adj = adj->next) {
+      if(adj->edge != a) degree += 1;
+    }
+    paths += (long long) degree * (degree - 1) / 2;
+    for(int b = a + 1; b < 300; b++) {
+      if(!containsEdge(g, a, b)) continue;
+      for(int c = b + 1; c < 300; c++) {
+        if(containsEdge(g, b, c) && containsEdge(g, a, c)) {
+          triangles += 1;
+          expected[a] += 1;
+          expected[b] += 1;
+          expected[c] += 1;
+        }
+      }
+    }
+  }
+
+  for(int threads = 1; threads <= 4; threads *= 4) {
+    setNumberOfThreads(threads);
+    assert(getTriangleCount(g, vertexTriangles) == triangles && getTriangleCount(g, NULL) == triangles);
+    for(int v = 0; v < 300; v++) {
+      assert(vertexTriangles[v] == expected[v]);
+    }
+    assert(closeTo(getTransitivity(g), 3.0 * triangles / paths, 1e-12));
+  }
+  setNumberOfThreads(1);
+  assert(triangles > 0);
+  destroyGraph(g);
+
+  // In a clique the oriented lists go from 39 neighbours down to 1, so the galloping search is used
+  g = initializeGraph(false);
+  addVertex(g, 40);
+  for(int a = 0; a < 40; a++) {
+    for(int b = a + 1; b < 40; b++) {
+      addEdge(g, a, b);
+    }
+  }
+  assert(getTriangleCount(g, vertexTriangles) == 9880);
+  for(int v = 0; v < 40; v++) {
+    assert(vertexTriangles[v] == 741);
+  }
+  assert(closeTo(getTransitivity(g), 1, 1e-12));
+  destroyGraph(g);
+
+  g = prepareDirectedGraphTest();
+  assert(getTriangleCount(g, NULL) == -1 && getClusteringCoefficients(g) == NULL && getTransitivity(g) == -1);
+  destroyGraph(g);
+}
+
+void kCoreTest() {
+  graph *g = initializeGraph(false);
+  graph *kcore = NULL;
+  int *core = NULL;
+  int *newId = NULL;
+  bool alive[400];
+  int degree[400];
+  int degeneracy, expectedCore, size;
+  bool changed;
+
+  // A 4-clique with a triangle and a path attached, and a self-loop that doesn't count
+  addVertex(g, 8);
+  for(int a = 0; a < 4; a++) {
+    for(int b = a + 1; b < 4; b++) {
+      addEdge(g, a, b);
+    }
+  }
+  addEdge(g, 3, 4);
+  addEdge(g, 4, 5);
+  addEdge(g, 5, 3);
+  addEdge(g, 5, 6);
+  addEdge(g, 6, 6);
+  core = getCoreNumbers(g, &degeneracy);
+  assert(degeneracy == 3 && core[0] == 3 && core[3] == 3 && core[4] == 2 && core[5] == 2);
+  assert(core[6] == 1 && core[7] == 0);
+  free(core);
+  destroyGraph(g);
+
+  // Compare with peeling the vertices of degree less than k, for each k
+  g = prepareRandomUndirectedGraph(400, 3, 97);
+  setLazyVertexRemoval(g, true);
+  removeVertex(g, 11);
+  core = getCoreNumbers(g, &degeneracy);
+  for(int k = 0; k <= degeneracy + 1; k++) {
+    for(int v = 0; v < 400; v++) {
+      alive[v] = containsVertex(g, v);
+    }
+    do {
+      changed = false;
+      for(int v = 0; v < 400; v++) {
+        if(!alive[v]) continue;
+        degree[v] = 0;
+        for(edgenode *adj = getAdjacent(g, v); adj != NULL; adj = adj->next) {
+          if(adj->edge != v && alive[adj->edge]) degree[v] += 1;
+        }
+        if(degree[v] < k) {
+          alive[v] = false;
+          changed = true;
+        }
+      }
+    } while(changed);
+
+    kcore = getKCore(g, k, &newId);
+    size = 0;
+    for(int v = 0; v < 400; v++) {
+      expectedCore = containsVertex(g, v) && core[v] >= k;
+      assert(alive[v] == expectedCore);
+      assert(alive[v] ? newId[v] == size++ : newId[v] == -1);
+    }
+    assert(kcore->size == size);
+    for(int v = 0; v < 400; v++) {
+      if(!alive[v]) continue;
+      for(int u = 0; u < 400; u++) {
+        if(!alive[u]) continue;
+        assert(containsEdge(g, v, u) == containsEdge(kcore, newId[v], newId[u]));
+        if(containsEdge(g, v, u)) assert(getEdgeWeight(g, v, u) == getEdgeWeight(kcore, newId[v], newId[u]));
+      }
+    }
+    assert(k != degeneracy + 1 || size == 0);
+    free(newId);
+    destroyGraph(kcore);
+  }
+  free(core);
+  destroyGraph(g);
+
+  g = prepareDirectedGraphTest();
+  assert(getCoreNumbers(g, NULL) == NULL && getKCore(g, 1, NULL) == NULL);
+  destroyGraph(g);
+}
+
+/**
+ * Counts the connected components without a vertex and an edge (-1 for none). If component is not -1, only the
+ * edges of that biconnected component are used and only their endpoints are counted.
+ */
+int countComponentsWithout(graph *g, int vertex, int source, int destination, int component, biconnectedComponents *b) {
+  int parent[g->size];
+  int count = 0;
+  int a, c, ra, rc;
+
+  for(int v = 0; v < g->size; v++) {
+    parent[v] = containsVertex(g, v) && v != vertex && component == -1 ? v : -1;
+  }
+  for(int i = 0; component != -1 && i < b->nedges; i++) {
+    if(b->component[i] != component) continue;
+    if(b->edges[i].source != vertex) parent[b->edges[i].source] = b->edges[i].source;
+    if(b->edges[i].destination != vertex) parent[b->edges[i].destination] = b->edges[i].destination;
+  }
+  for(int v = 0; v < g->size; v++) {
+    for(edgenode *adj = getAdjacent(g, v); adj != NULL; adj = adj->next) {
+      a = v;
+      c = adj->edge;
+      if(parent[a] == -1 || parent[c] == -1) continue;
+      if((a == source && c == destination) || (a == destination && c == source)) continue;
+      if(component != -1) {
+        bool inside = false;
+        for(int i = 0; i < b->nedges; i++) {
+          if(b->component[i] == component && b->edges[i].source == (a < c ? a : c) && b->edges[i].destination == (a < c ? c : a)) inside = true;
+        }
+        if(!inside) continue;
+      }
+      for(ra = a; parent[ra] != ra; ra = parent[ra]);
+      for(rc = c; parent[rc] != rc; rc = parent[rc]);
+      parent[ra] = rc;
+    }
+  }
+  for(int v = 0; v < g->size; v++) {
+    if(parent[v] == v) count += 1;
+  }
+
+  return count;
+}
+
+void biconnectedComponentsTest() {
+  graph *g = initializeGraph(false);
+  biconnectedComponents *b = NULL;
+  int blocks[300];
+  int expectedBridges, expectedArticulation, components;
+  int lastBlock[300];
+
+  // Two triangles joined by the bridge (2, 3), a pendant vertex 6 and a self-loop
+  addVertex(g, 8);
+  addEdge(g, 0, 1);
+  addEdge(g, 1, 2);
+  addEdge(g, 2, 0);
+  addEdge(g, 2, 3);
+  addEdge(g, 3, 4);
+  addEdge(g, 4, 5);
+  addEdge(g, 5, 3);
+  addEdge(g, 5, 6);
+  addEdge(g, 1, 1);
+  b = getBiconnectedComponents(g);
+  assert(b->nedges == 8 && b->ncomponents == 4 && b->nbridges == 2 && b->narticulationPoints == 3);
+  assert(b->articulationPoints[0] == 2 && b->articulationPoints[1] == 3 && b->articulationPoints[2] == 5);
+  for(int i = 0; i < b->nbridges; i++) {
+    assert((b->bridges[i].source == 2 && b->bridges[i].destination == 3) || (b->bridges[i].source == 5 && b->bridges[i].destination == 6));
+  }
+  for(int i = 0; i < b->nedges; i++) {
+    for(int j = 0; j < b->nedges; j++) {
+      bool sameTriangle = (b->edges[i].destination <= 2 && b->edges[j].destination <= 2) ||
+        (b->edges[i].source >= 3 && b->edges[i].destination <= 5 && b->edges[j].source >= 3 && b->edges[j].destination <= 5);
+      assert((b->component[i] == b->component[j]) == (i == j || sameTriangle));
+    }
+  }
+  destroyBiconnectedComponents(b);
+  destroyGraph(g);
+
+  // Compare with removing each vertex and each edge
+  g = prepareRandomUndirectedGraph(120, 1, 101);
+  for(int v = 0; v < 120; v += 7) {
+    removeEdge(g, v, (v + 1) % 120);
+  }
+  setLazyVertexRemoval(g, true);
+  removeVertex(g, 40);
+  b = getBiconnectedComponents(g);
+  components = countComponentsWithout(g, -1, -1, -1, -1, NULL);
+
+  expectedBridges = 0;
+  for(int v = 0; v < 120; v++) {
+    for(edgenode *adj = getAdjacent(g, v); adj != NULL; adj = adj->next) {
+      if(adj->edge > v && countComponentsWithout(g, -1, v, adj->edge, -1, NULL) > components) {
+        bool found = false;
+        for(int i = 0; i < b->nbridges; i++) {
+          if(b->bridges[i].source == v && b->bridges[i].destination == adj->edge) found = true;
+        }
+        assert(found);
+        expectedBridges += 1;
+      }
+    }
+  }
+  assert(b->nbridges == expectedBridges && expectedBridges > 0);
+
+  // The articulation points are the vertices in more than one biconnected component
+  for(int v = 0; v < 120; v++) {
+    blocks[v] = 0;
+    lastBlock[v] = -1;
+  }
+  for(int c = 0; c < b->ncomponents; c++) {
+    for(int i = 0; i < b->nedges; i++) {
+      if(b->component[i] != c) continue;
+      if(lastBlock[b->edges[i].source] != c) blocks[b->edges[i].source] += 1;
+      if(lastBlock[b->edges[i].destination] != c) blocks[b->edges[i].destination] += 1;
+      lastBlock[b->edges[i].source] = c;
+      lastBlock[b->edges[i].destination] = c;
+    }
+  }
+  expectedArticulation = 0;
+  for(int v = 0; v < 120; v++) {
+    if(!containsVertex(g, v)) continue;
+    if(countComponentsWithout(g, v, -1, -1, -1, NULL) > components - (getAdjacent(g, v) == NULL ? 1 : 0)) {
+      assert(b->articulationPoints[expectedArticulation++] == v);
+      assert(blocks[v] >= 2);
+    } else {
+      assert(blocks[v] <= 1);
+    }
+  }
+  assert(b->narticulationPoints == expectedArticulation && expectedArticulation > 0);
+
+  // Each component stays connected without any one of its vertices
+  for(int c = 0; c < b->ncomponents; c++) {
+    for(int v = 0; v < 120; v++) {
+      if(lastBlock[v] == -1) continue;
+      assert(countComponentsWithout(g, v, -1, -1, c, b) <= 1);
+    }
+  }
+
+  destroyBiconnectedComponents(b);
+  destroyGraph(g);
+
+  g = prepareDirectedGraphTest();
+  assert(getBiconnectedComponents(g) == NULL);
+  destroyGraph(g);
+}
+
+/**
+ * Checks the capacities and the conservation of the flow, and that the minimum cut has the capacity of the flow.
+ */
+bool validMaximumFlow(flowNetwork *f, int source, int sink, long long value) {
+  long long balance[f->size];
+  long long cut = 0;
+  bool *sourceSide = getMinCut(f);
+  weightedEdge *e = NULL;
+  long long flow;
+
+  for(int v = 0; v < f->size; v++) {
+    balance[v] = 0;
+  }
+  for(int i = 0; i < f->nedges; i++) {
+    e = &f->edges[i];
+    flow = getEdgeFlow(f, e->source, e->destination);
+    if(flow < 0 || flow > e->weight || flow != f->flow[f->edgeArc[i]]) return false;
+    balance[e->source] -= flow;
+    balance[e->destination] += flow;
+    if(sourceSide[e->source] && !sourceSide[e->destination]) {
+      if(flow != e->weight) return false;
+      cut += e->weight;
+    }
+    if(!sourceSide[e->source] && sourceSide[e->destination] && flow != 0) return false;
+  }
+  for(int v = 0; v < f->size; v++) {
+    if(v != source && v != sink && balance[v] != 0) return false;
+  }
+
+  free(sourceSide);
+  return f->value == value && balance[sink] == value && balance[source] == -value && cut == value;
+}
+
+void maxFlowTest() {
+  graph *g = initializeGraph(true);
+  flowNetwork *f = NULL;
+  flowNetwork *fresh = NULL;
+  unsigned int seed = 103;
+  long long value;
+  weightedEdge e;
+  int capacity;
+
+  // The example of Cormen et al.
+  addVertex(g, 6);
+  addEdgeWeight(g, 0, 1, 16);
+  addEdgeWeight(g, 0, 2, 13);
+  addEdgeWeight(g, 1, 2, 10);
+  addEdgeWeight(g, 2, 1, 4);
+  addEdgeWeight(g, 1, 3, 12);
+  addEdgeWeight(g, 3, 2, 9);
+  addEdgeWeight(g, 2, 4, 14);
+  addEdgeWeight(g, 4, 3, 7);
+  addEdgeWeight(g, 3, 5, 20);
+  addEdgeWeight(g, 4, 5, 4);
+  f = initializeFlowNetwork(g);
+  assert(getMinCut(f) == NULL && getMaxFlow(f, 0, 0) == -1 && getMaxFlow(f, 0, 6) == -1);
+  assert(getMaxFlow(f, 0, 5) == 23 && validMaximumFlow(f, 0, 5, 23));
+  assert(getEdgeFlow(f, 3, 5) == 19 && getEdgeFlow(f, 4, 5) == 4 && getEdgeFlow(f, 5, 3) == -1);
+
+  // Lowering the capacity of a saturated edge into the sink lowers the flow, raising it back restores it
+  assert(setFlowCapacity(f, 4, 5, 1) && validMaximumFlow(f, 0, 5, 20));
+  assert(getMaxFlow(f, 0, 5) == 20);
+  assert(setFlowCapacity(f, 4, 5, 4) && getMaxFlow(f, 0, 5) == 23);
+  assert(!setFlowCapacity(f, 5, 4, 1) && !setFlowCapacity(f, 4, 5, -1));
+  assert(getMaxFlow(f, 1, 4) == 14 && validMaximumFlow(f, 1, 4, 14));
+  destroyFlowNetwork(f);
+  destroyGraph(g);
+
+  // Random capacity changes: the warm start must reach the value computed from scratch
+  g = initializeGraph(true);
+  addVertex(g, 80);
+  for(int i = 0; i < 400; i++) {
+    seed = seed * 1103515245 + 12345;
+    int a = (seed >> 8) % 80;
+    seed = seed * 1103515245 + 12345;
+    int b = (seed >> 8) % 80;
+    addEdgeWeight(g, a, b, (seed >> 16) % 20);
+  }
+  f = initializeFlowNetwork(g);
+  value = getMaxFlow(f, 0, 79);
+  assert(value > 0 && validMaximumFlow(f, 0, 79, value));
+
+  for(int round = 0; round < 50; round++) {
+    for(int i = 0; i < 5; i++) {
+      seed = seed * 1103515245 + 12345;
+      e = f->edges[(seed >> 8) % f->nedges];
+      capacity = round % 3 == 0 ? (int) ((seed >> 16) % 30) : (int) ((seed >> 16) % (e.weight + 1));
+      assert(setFlowCapacity(f, e.source, e.destination, capacity));
+      setEdgeWeight(g, e.source, e.destination, capacity);
+      assert(f->value <= value || capacity > e.weight);
+    }
+
+    value = getMaxFlow(f, 0, 79);
+    fresh = initializeFlowNetwork(g);
+    assert(getMaxFlow(fresh, 0, 79) == value);
+    assert(validMaximumFlow(f, 0, 79, value));
+    destroyFlowNetwork(fresh);
+  }
+  destroyFlowNetwork(f);
+
+  setEdgeWeight(g, e.source, e.destination, -1);
+  assert(initializeFlowNetwork(g) == NULL);
+  destroyGraph(g);
+
+  g = prepareUndirectedGraphTest();
+  assert(initializeFlowNetwork(g) == NULL);
+  destroyGraph(g);
 }
\ No newline at end of file